@@ -0,0 +1,1041 @@
+#include "ambient_engine.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "denormals.h"
+#include "fast_math.h"
+#include "sample_data.h"
+
+using namespace daisysp;
+
+namespace ambient {
+
+struct SparkleParams {
+    float brightness;
+    float brightness_lfo_rate;
+    float brightness_lfo_depth;
+    float structure;
+    float damping;
+    float accent;
+    float volume;
+};
+
+static const float FOLLOWER_TRIGGER_POINTS[3] = {0.4f, 0.1f, 0.7f};
+
+// Sequencer voices played by the drone lanes and by followers 0-2 (sparkles, pad).
+static const int LEADER_VOICES[3]   = {0, 2, 4};
+static const int FOLLOWER_VOICES[3] = {1, 3, 5};
+
+static const SparkleParams SPARKLE_PARAMS[2] = {
+    {0.45f, 0.07f, 0.15f, 0.40f, 0.35f, 0.6f, 0.22f},
+    {0.35f, 0.05f, 0.12f, 0.35f, 0.28f, 0.5f, 0.18f},
+};
+
+static const struct {
+    float attack;
+    float min_decay;
+    float max_decay;
+    float sustain;
+    float release;
+    float filter_freq;
+    float filter_res;
+    float noise_filter_freq;
+    float noise_mix;
+    float detune_cents;
+    float vibrato_rate;
+    float vibrato_depth;
+    float decay_lfo_rate;
+    float volume;
+} PAD_PARAMS = {
+    1.2f,
+    1.0f,
+    4.0f,
+    0.4f,
+    6.0f,
+    700.0f,
+    0.12f,
+    2200.0f,
+    0.10f,
+    18.0f,
+    5.2f,
+    4.0f,
+    0.03f,
+    0.15f,
+};
+
+static const float SAMPLE_FILTER_FREQ      = 1200.0f;
+static const float SAMPLE_FILTER_LFO_RATE  = 0.012f;
+static const float SAMPLE_FILTER_LFO_DEPTH = 180.0f;
+static const float SAMPLE_VOLUME           = 0.08f;
+static const SampleInterp SAMPLE_INTERP    = SAMPLE_INTERP_HERMITE; // used when the rate is not 1
+
+static const float DRONE_DRY      = 1.0f;
+static const float DRONE_DELAY    = 0.05f;
+static const float DRONE_REVERB   = 0.08f;
+static const float SPARKLE_DRY    = 0.60f;
+static const float SPARKLE_DELAY  = 0.35f;
+static const float SPARKLE_REVERB = 0.50f;
+static const float PAD_DRY        = 0.80f;
+static const float PAD_DELAY      = 0.15f;
+static const float PAD_REVERB     = 0.30f;
+
+// The right repeats trail the left by this much.
+static const float DELAY_R_OFFSET_SEC = 0.018f;
+
+// Per-sample LED follower coefficients; LedMeter applies them once per Process call.
+static const float LED_ATTACK  = 0.08f;
+static const float LED_RELEASE = 0.0025f;
+
+// Pad voices started per trigger, spread evenly over this many cents and mixed at
+// 1/sqrt(layers) so the layered pad keeps the single voice's loudness.
+#if defined(AMBIENT_VOICES_LAYERED)
+static const int   PAD_LAYERS             = 2;
+#else
+static const int   PAD_LAYERS             = 1;
+#endif
+static const float PAD_LAYER_SPREAD_CENTS = 7.0f;
+
+// Shed voices fade out over this many samples; the pad layers left play louder to match.
+static const uint32_t VOICE_SHED_FADE_SAMPLES = 256;
+static const int      MIN_FOLLOWER_VOICES     = 3; // the CPU budget never goes below one per follower
+static const float    VOICE_LEVEL_DECAY       = 0.9995f; // per-sample release of the pooled voices' peak level
+
+// A sparkle whose output stays below -100 dBFS for this long is put to sleep.
+static const float    kSilenceThreshold   = 1.0e-5f;
+static const uint32_t kSilenceHoldSamples = 1024;
+
+static inline float Clampf(float x, float lo, float hi) {
+    return fmaxf(lo, fminf(hi, x));
+}
+
+// =============================================
+// VOICES
+// =============================================
+
+void SparkleVoice::Init(float sample_rate, int index) {
+    string.Init(sample_rate);
+    string.SetFreq(440.0f);
+    string.SetSustain(false);
+    Configure(index);
+
+    quiet_samples = 0;
+    asleep        = false;
+}
+
+void SparkleVoice::Configure(int index) {
+    const SparkleParams& p = SPARKLE_PARAMS[index];
+    string.SetStructure(p.structure);
+    string.SetBrightness(p.brightness);
+    string.SetDamping(p.damping);
+    string.SetAccent(p.accent);
+    volume = p.volume;
+}
+
+void SparkleVoice::Render(float* out, size_t size) {
+    size_t i = 0;
+    if(!asleep) {
+        for(; i < size; i++) {
+            const float s = string.Process() * volume;
+            out[i]        = s;
+            quiet_samples = fabsf(s) < kSilenceThreshold ? quiet_samples + 1u : 0u;
+            if(quiet_samples >= kSilenceHoldSamples) {
+                asleep = true;
+                i++;
+                break;
+            }
+        }
+    }
+    for(; i < size; i++) {
+        out[i] = 0.0f;
+    }
+}
+
+void PadVoice::Init(float sr) {
+    sample_rate = sr;
+
+    osc1.Init(sample_rate);
+    osc1.SetWaveform(Oscillator::WAVE_TRI);
+    osc1.SetAmp(1.0f);
+
+    osc2.Init(sample_rate);
+    osc2.SetWaveform(Oscillator::WAVE_TRI);
+    osc2.SetAmp(1.0f);
+
+    ResetState();
+
+    env.Init(sample_rate);
+    env.SetTime(ADSR_SEG_ATTACK, PAD_PARAMS.attack);
+    env.SetTime(ADSR_SEG_DECAY, PAD_PARAMS.min_decay);
+    env.SetSustainLevel(PAD_PARAMS.sustain);
+    env.SetTime(ADSR_SEG_RELEASE, PAD_PARAMS.release);
+
+    env_gate            = false;
+    target_freq         = 349.23f;
+    current_freq        = 349.23f;
+    volume              = PAD_PARAMS.volume;
+    noise_mix           = PAD_PARAMS.noise_mix;
+    vibrato_depth_cents = PAD_PARAMS.vibrato_depth;
+    detune_cents        = PAD_PARAMS.detune_cents;
+}
+
+void PadVoice::ResetState() {
+    osc1.Reset();
+    osc2.Reset();
+
+    noise.Init();
+
+    noise_filter.Init(sample_rate);
+    noise_filter.SetFreq(PAD_PARAMS.noise_filter_freq);
+    noise_filter.SetRes(0.3f);
+
+    filter.Init(sample_rate);
+    filter.SetFreq(PAD_PARAMS.filter_freq);
+    filter.SetRes(PAD_PARAMS.filter_res);
+
+    vibrato_lfo.Init(sample_rate, ControlLfo::SHAPE_SIN, PAD_PARAMS.vibrato_rate);
+    vibrato_ratio.Reset(1.0f);
+    control_left = 0;
+}
+
+bool PadVoice::Idle() const {
+    return !env_gate && !env.IsRunning();
+}
+
+void PadVoice::Render(float* out, size_t size, uint32_t control_period) {
+    const float detune_ratio = fastmath::cents_to_ratio(detune_cents);
+
+    // Released and silent: only the vibrato LFO moves until the next trigger.
+    const bool idle = Idle();
+
+    size_t i = 0;
+    while(i < size) {
+        if(control_left == 0) {
+            const float vib = vibrato_lfo.Process(control_period);
+            vibrato_ratio.SetTarget(fastmath::cents_to_ratio(vib * vibrato_depth_cents), control_period);
+            control_left = control_period;
+        }
+
+        const size_t n   = size - i < control_left ? size - i : control_left;
+        const size_t end = i + n;
+        control_left -= static_cast<uint32_t>(n);
+
+        if(idle) {
+            for(; i < end; i++) {
+                out[i] = 0.0f;
+            }
+            continue;
+        }
+
+        for(; i < end; i++) {
+            const float freq_with_vibrato = current_freq * vibrato_ratio.Next();
+
+            osc1.SetFreq(freq_with_vibrato);
+            osc2.SetFreq(freq_with_vibrato * detune_ratio);
+
+            const float osc_sig = (osc1.Process() + osc2.Process()) * 0.5f;
+
+            const float raw_noise = noise.Process();
+            noise_filter.Process(raw_noise);
+            const float shaped_noise = noise_filter.Band();
+
+            float sig = osc_sig * (1.0f - noise_mix) + shaped_noise * noise_mix;
+
+            filter.Process(sig);
+            sig = filter.Low();
+
+            const float amp = env.Process(env_gate);
+            out[i] = sig * (amp * volume);
+        }
+    }
+}
+
+void SamplePlayer::Init(float sample_rate) {
+    // The bed keeps its pitch at any engine rate: a blob converted for another
+    // rate is resampled by the read position's step (exactly 1 when they match).
+    // One too far off for SetPlaybackRate's range stays silent.
+    const float rate = static_cast<float>(sample_data.sample_rate) / sample_rate;
+    if(rate <= 4.0f) {
+        stream.Init(sample_data.data, sample_data.length, sample_data.codec, sample_data.loop_start, sample_data.loop_end);
+    } else {
+        stream.Init(nullptr, 0, SAMPLE_CODEC_PCM16, 0, 0);
+    }
+    position = 0;
+    interp   = SAMPLE_INTERP;
+    SetPlaybackRate(rate);
+    filter.Init(sample_rate, 0.08f);
+    filter.SetFreq(Clampf(SAMPLE_FILTER_FREQ + SAMPLE_FILTER_LFO_DEPTH, 300.0f, 2500.0f));
+    filter_lfo.Init(sample_rate, ControlLfo::SHAPE_TRI, SAMPLE_FILTER_LFO_RATE);
+    control_left     = 0;
+    base_filter_freq = SAMPLE_FILTER_FREQ;
+    lfo_depth        = SAMPLE_FILTER_LFO_DEPTH;
+    volume           = SAMPLE_VOLUME;
+}
+
+static const uint64_t kPositionOne = 1ull << 32;
+
+void SamplePlayer::SetPlaybackRate(float rate) {
+    increment = static_cast<uint64_t>(static_cast<double>(Clampf(rate, 0.0f, 4.0f)) * static_cast<double>(kPositionOne));
+}
+
+// The loop seam and the intro fade-in are baked into the asset by
+// tools/convert_sample.py, so a run is just reads through the stream ring: no
+// wrap test, no modulo, no fade gain.
+template <SampleInterp Mode>
+void SamplePlayer::RenderRun(float* out, size_t n) {
+    static const float kInt16ToFloat = 1.0f / 32768.0f;
+    static const float kFracScale    = 1.0f / 4294967296.0f;
+
+    for(size_t i = 0; i < n; i++) {
+        const uint32_t idx = static_cast<uint32_t>(position >> 32);
+        float raw;
+        if(Mode == SAMPLE_INTERP_NONE) {
+            raw = static_cast<float>(stream.At(idx)) * kInt16ToFloat;
+        } else if(Mode == SAMPLE_INTERP_LINEAR) {
+            const int16_t* x    = stream.Frame(idx);
+            const float    frac = static_cast<float>(static_cast<uint32_t>(position)) * kFracScale;
+            const float    s0   = static_cast<float>(x[0]);
+            const float    s1   = static_cast<float>(x[1]);
+            raw = (s0 + frac * (s1 - s0)) * kInt16ToFloat;
+        } else {
+            const int16_t* x    = stream.Frame(idx - 1u);
+            const float    frac = static_cast<float>(static_cast<uint32_t>(position)) * kFracScale;
+            const float    xm1  = static_cast<float>(x[0]);
+            const float    x0   = static_cast<float>(x[1]);
+            const float    x1   = static_cast<float>(x[2]);
+            const float    x2   = static_cast<float>(x[3]);
+            const float    c1   = 0.5f * (x1 - xm1);
+            const float    c2   = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+            const float    c3   = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+            raw = (((c3 * frac + c2) * frac + c1) * frac + x0) * kInt16ToFloat;
+        }
+
+        filter.Process(raw);
+        out[i] = filter.Low() * volume;
+        position += increment;
+    }
+}
+
+void SamplePlayer::Render(float* out, size_t size, uint32_t control_period) {
+    if(stream.Length() <= 1u) {
+        for(size_t i = 0; i < size; i++) {
+            out[i] = 0.0f;
+        }
+        return;
+    }
+
+    // Every position this run can touch, plus the Hermite neighbours.
+    const uint32_t first = static_cast<uint32_t>(position >> 32);
+    stream.FillTo(first + static_cast<uint32_t>((increment * size) >> 32) + 3u);
+
+    // Whole positions at unity rate stay whole, so the choice holds for the run.
+    const bool         copy = increment == kPositionOne && static_cast<uint32_t>(position) == 0u;
+    const SampleInterp  mode = copy ? SAMPLE_INTERP_NONE : interp;
+
+    size_t i = 0;
+    while(i < size) {
+        if(control_left == 0) {
+            const float lfo_val = filter_lfo.Process(control_period);
+            float cutoff = base_filter_freq + (lfo_val * lfo_depth);
+            cutoff = Clampf(cutoff, 300.0f, 2500.0f);
+            filter.SetFreqTarget(cutoff, control_period);
+            control_left = control_period;
+        }
+
+        const size_t n = size - i < control_left ? size - i : control_left;
+        control_left -= static_cast<uint32_t>(n);
+
+        switch(mode) {
+            case SAMPLE_INTERP_NONE:
+                RenderRun<SAMPLE_INTERP_NONE>(out + i, n);
+                break;
+            case SAMPLE_INTERP_LINEAR:
+                RenderRun<SAMPLE_INTERP_LINEAR>(out + i, n);
+                break;
+            case SAMPLE_INTERP_HERMITE:
+                RenderRun<SAMPLE_INTERP_HERMITE>(out + i, n);
+                break;
+        }
+        i += n;
+    }
+}
+
+void Engine::Init(float sample_rate, DelayBuffer* delay, int start_root, uint32_t start_cycle) {
+    sample_rate_ = sample_rate;
+    delay_       = delay;
+
+    bpm_             = 50.0f;
+    reverb_feedback_ = 0.90f;
+    reverb_lpfreq_   = 6500.0f;
+    delay_time_sec_  = 0.85f;
+    delay_feedback_  = 0.25f;
+
+    drones_.Init(sample_rate_, kDroneParams);
+    for(int di = 0; di < 3; di++) {
+        drone_freq_[di] = drones_.Freq(di);
+    }
+    drone_gate_    = 0;
+    drone_changes_ = RunRecord{};
+    delay_change_  = 0.0f;
+
+    for(int i = 0; i < kSparkleVoices; i++) {
+        sparkles_[i].Init(sample_rate_, 0);
+    }
+    for(int i = 0; i < kPadVoices; i++) {
+        pads_[i].Init(sample_rate_);
+    }
+    sampler_.Init(sample_rate_);
+
+    for(int i = 0; i < 2; i++) {
+        sparkle_brightness_lfo_[i].Init(sample_rate_, ControlLfo::SHAPE_TRI, SPARKLE_PARAMS[i].brightness_lfo_rate);
+    }
+    pad_decay_lfo_.Init(sample_rate_, ControlLfo::SHAPE_TRI, PAD_PARAMS.decay_lfo_rate);
+
+    sparkle_pool_.Init();
+    pad_pool_.Init();
+    budget_.Init(MIN_FOLLOWER_VOICES, kSparkleVoices + kPadVoices);
+    next_group_ = 0;
+
+    reverb_.Init(sample_rate_);
+    reverb_.SetFeedback(reverb_feedback_);
+    reverb_.SetLpFreq(reverb_lpfreq_);
+
+    delay_->Init();
+    delay_->SetRightOffset(static_cast<uint32_t>(DELAY_R_OFFSET_SEC * sample_rate_ + 0.5f));
+    delay_->SetDelay(delay_time_sec_ * sample_rate_);
+
+    sequencer_.Init(start_root, start_cycle);
+
+    cycle_duration_sec_ = 60.0f / bpm_ * 4.0f;
+    samples_per_cycle_  = static_cast<uint32_t>(cycle_duration_sec_ * sample_rate_);
+    sample_clock_       = 0;
+    cycle_start_        = 0;
+    control_period_     = kDefaultControlPeriod;
+    trigger_lfo_left_   = control_period_;
+
+    // The first cycle plays the initial sequencer state; its tick comes at the end.
+    events_.Clear();
+    ScheduleCycle();
+
+    controls_.Clear();
+    meter_.Init(LED_ATTACK, LED_RELEASE);
+    PublishMeters(VoiceStatus());
+
+#if defined(AMBIENT_PROFILE)
+    profiler_.Init();
+#endif
+}
+
+void Engine::SetControlPeriod(uint32_t samples) {
+    control_period_ = samples > 0 ? samples : 1;
+    drones_.SetControlPeriod(control_period_);
+    for(int i = 0; i < kPadVoices; i++) {
+        if(pads_[i].control_left > control_period_) {
+            pads_[i].control_left = control_period_;
+        }
+    }
+    if(sampler_.control_left > control_period_) {
+        sampler_.control_left = control_period_;
+    }
+    if(trigger_lfo_left_ > control_period_) {
+        trigger_lfo_left_ = control_period_;
+    }
+}
+
+uint32_t Engine::ElapsedMs() const {
+    return static_cast<uint32_t>(sample_clock_ * 1000u / static_cast<uint64_t>(sample_rate_));
+}
+
+void Engine::ProcessCycleTick() {
+    sequencer_.Advance();
+    const turing::SequencerState& seq = sequencer_.Live();
+
+    // Recorded here and applied by the leader stage before its next run.
+    for(int di = 0; di < 3; di++) {
+        auto&         voice = seq.voices[LEADER_VOICES[di]];
+        const uint8_t bit   = static_cast<uint8_t>(1u << di);
+
+        if(voice.gate) {
+            if(!voice.prev_gate) {
+                drone_freq_[di] = voice.freq;
+                drone_gate_ |= bit;
+                drone_changes_.drone_freq_set |= bit;
+                drone_changes_.drone_gate_set |= bit;
+            } else if(fabsf(voice.freq - drone_freq_[di]) > 0.1f) {
+                drone_freq_[di] = voice.freq;
+                drone_changes_.drone_freq_set |= bit;
+            }
+        } else if(voice.prev_gate) {
+            drone_gate_ = static_cast<uint8_t>(drone_gate_ & ~bit);
+            drone_changes_.drone_gate_set |= bit;
+        }
+    }
+}
+
+void Engine::TakeDroneChanges(RunRecord& run) {
+    run.drone_freq_set = drone_changes_.drone_freq_set;
+    run.drone_gate_set = drone_changes_.drone_gate_set;
+    run.drone_gate     = drone_gate_;
+    for(int di = 0; di < 3; di++) {
+        run.drone_freq[di] = drone_freq_[di];
+    }
+    drone_changes_.drone_freq_set = 0;
+    drone_changes_.drone_gate_set = 0;
+}
+
+void Engine::TriggerFollower(int fi) {
+    const auto& voice = sequencer_.Live().voices[FOLLOWER_VOICES[fi]];
+    if(!voice.gate) {
+        return;
+    }
+    if(fi < 2) {
+        TriggerSparkle(fi, voice.freq);
+    } else {
+        TriggerPad(voice.freq);
+    }
+    next_group_++;
+}
+
+// Voices a pool may start before it has to steal: what the budget leaves after
+// the other pool's voices.
+static int PoolLimit(int budget, int total, int pool_count) {
+    const int limit = pool_count + (budget - total);
+    return limit > 0 ? limit : 0;
+}
+
+void Engine::TriggerSparkle(int fi, float freq) {
+#if defined(AMBIENT_VOICES_LAYERED)
+    const int total = sparkle_pool_.Count() + pad_pool_.Count();
+    const int slot  = sparkle_pool_.Allocate(PoolLimit(budget_.Voices(), total, sparkle_pool_.Count()), next_group_);
+    if(slot < 0) {
+        return; // every voice is already fading out
+    }
+#else
+    const int slot = fi; // one string per follower, cut off by its next pluck
+#endif
+
+    // A fresh or stolen string: both restart from silence.
+    auto& sp = sparkles_[slot];
+    sp.string.Reset();
+    sp.asleep        = false;
+    sp.quiet_samples = 0;
+    sp.Configure(fi);
+    sp.string.SetFreq(freq);
+
+    const float lfo_val    = sparkle_brightness_lfo_[fi].Value();
+    const float brightness = Clampf(SPARKLE_PARAMS[fi].brightness + lfo_val * SPARKLE_PARAMS[fi].brightness_lfo_depth, 0.1f, 0.8f);
+    sp.string.SetBrightness(brightness);
+
+    const float rand = static_cast<float>(ElapsedMs() % 1000) / 1000.0f;
+    sp.volume        = SPARKLE_PARAMS[fi].volume * (0.6f + 0.8f * rand);
+
+    sp.string.Trig();
+
+    // Plucks have no gate: they count as released, so they are stolen before held pads.
+    sparkle_pool_.Start(slot, fi, next_group_, sample_clock_, 1.0f);
+    sparkle_pool_[slot].released = true;
+}
+
+void Engine::TriggerPad(float freq) {
+    const float decay_norm = (pad_decay_lfo_.Value() + 1.0f) * 0.5f;
+    const float decay_time = PAD_PARAMS.min_decay + decay_norm * (PAD_PARAMS.max_decay - PAD_PARAMS.min_decay);
+    const float layer_gain = 1.0f / sqrtf(static_cast<float>(PAD_LAYERS));
+
+    int slots[PAD_LAYERS];
+    int started = 0;
+    for(int layer = 0; layer < PAD_LAYERS; layer++) {
+        const int total = sparkle_pool_.Count() + pad_pool_.Count();
+        const int slot  = pad_pool_.Allocate(PoolLimit(budget_.Voices(), total, pad_pool_.Count()), next_group_);
+        if(slot < 0) {
+            continue; // nothing left to steal: the trigger plays fewer layers
+        }
+        auto& pad = pads_[slot];
+
+        // Stolen (or shed) while its envelope still runs: restart that from zero too.
+        if(!pad.Idle()) {
+            pad.env.Retrigger(true);
+        }
+        pad.ResetState();
+
+        const float spread = PAD_LAYERS > 1 ? PAD_LAYER_SPREAD_CENTS * (static_cast<float>(layer) / static_cast<float>(PAD_LAYERS - 1) - 0.5f)
+                                            : 0.0f;
+        pad.target_freq  = freq * fastmath::cents_to_ratio(spread);
+        pad.current_freq = pad.target_freq;
+        pad.env.SetTime(ADSR_SEG_DECAY, decay_time);
+        pad.env_gate = true;
+
+        pad_pool_.Start(slot, 2, next_group_, sample_clock_, layer_gain);
+        slots[started++] = slot;
+    }
+    if(started == 0) {
+        return;
+    }
+    // Dropped layers leave their power to the ones that started, as a shed layer does.
+    if(started < PAD_LAYERS) {
+        for(int i = 0; i < started; i++) {
+            pad_pool_[slots[i]].gain = 1.0f / sqrtf(static_cast<float>(started));
+        }
+    }
+
+    // The gate is held for the trigger sample plus 0.3 s.
+    const uint32_t pad_gate_samples = static_cast<uint32_t>(0.3f * sample_rate_);
+    Event release;
+    release.time        = sample_clock_ + pad_gate_samples + 1u;
+    release.cycle_point = -1.0f;
+    release.type        = EVENT_PAD_RELEASE;
+    release.index       = next_group_;
+    events_.Push(release);
+}
+
+void Engine::ReleasePad(uint8_t group) {
+    for(int v = 0; v < kPadVoices; v++) {
+        if(pad_pool_.Active(v) && pad_pool_[v].group == group) {
+            pads_[v].env_gate     = false;
+            pad_pool_[v].released = true;
+        }
+    }
+}
+
+void Engine::ShedVoices() {
+    int excess = sparkle_pool_.Count() + pad_pool_.Count() - budget_.Voices();
+    for(int v = 0; v < kSparkleVoices; v++) {
+        excess -= sparkle_pool_.Active(v) && sparkle_pool_[v].shedding ? 1 : 0;
+    }
+    for(int v = 0; v < kPadVoices; v++) {
+        excess -= pad_pool_.Active(v) && pad_pool_[v].shedding ? 1 : 0;
+    }
+
+    for(; excess > 0; excess--) {
+        const int sp = sparkle_pool_.Quietest(true);
+        const int pd = pad_pool_.Quietest(true);
+        if(sp < 0 && pd < 0) {
+            return;
+        }
+        const bool pick_pad = sp < 0 || (pd >= 0 && pad_pool_[pd].level * pad_pool_[pd].gain
+                                                        < sparkle_pool_[sp].level * sparkle_pool_[sp].gain);
+        if(!pick_pad) {
+            sparkle_pool_[sp].shedding = true;
+            sparkle_pool_.RampGain(sp, 0.0f, VOICE_SHED_FADE_SAMPLES);
+            continue;
+        }
+
+        // Merge a shed pad layer into its siblings: they take over its power.
+        pad_pool_[pd].shedding = true;
+        pad_pool_.RampGain(pd, 0.0f, VOICE_SHED_FADE_SAMPLES);
+        int siblings = 0;
+        for(int v = 0; v < kPadVoices; v++) {
+            siblings += pad_pool_.Active(v) && !pad_pool_[v].shedding && pad_pool_[v].group == pad_pool_[pd].group ? 1 : 0;
+        }
+        for(int v = 0; v < kPadVoices && siblings > 0; v++) {
+            if(pad_pool_.Active(v) && !pad_pool_[v].shedding && pad_pool_[v].group == pad_pool_[pd].group) {
+                const float gain = pad_pool_[v].gain * sqrtf(static_cast<float>(siblings + 1) / static_cast<float>(siblings));
+                pad_pool_.RampGain(v, gain, VOICE_SHED_FADE_SAMPLES);
+            }
+        }
+    }
+}
+
+// First sample of the cycle at which progress (sample / samples_per_cycle, in float)
+// reaches point; 1.0 gives the cycle length itself.
+static uint32_t TriggerSample(float point, uint32_t samples_per_cycle) {
+    const float spc = static_cast<float>(samples_per_cycle);
+    uint32_t    s   = static_cast<uint32_t>(point * spc);
+    while(s > 0 && static_cast<float>(s - 1) / spc >= point) {
+        s--;
+    }
+    while(static_cast<float>(s) / spc < point) {
+        s++;
+    }
+    return s;
+}
+
+void Engine::ScheduleCycle() {
+    Event ev;
+    ev.type = EVENT_FOLLOWER_TRIGGER;
+    for(int fi = 0; fi < 3; fi++) {
+        ev.cycle_point = FOLLOWER_TRIGGER_POINTS[fi];
+        ev.time        = cycle_start_ + TriggerSample(ev.cycle_point, samples_per_cycle_);
+        ev.index       = static_cast<uint8_t>(fi);
+        events_.Push(ev);
+    }
+
+    ev.type        = EVENT_CYCLE_TICK;
+    ev.cycle_point = 1.0f;
+    ev.time        = cycle_start_ + samples_per_cycle_;
+    ev.index       = 0;
+    events_.Push(ev);
+}
+
+void Engine::ApplyTempo(float bpm) {
+    const uint32_t old_samples_per_cycle = samples_per_cycle_;
+
+    bpm_                = bpm;
+    cycle_duration_sec_ = 60.0f / bpm_ * 4.0f;
+    samples_per_cycle_  = static_cast<uint32_t>(cycle_duration_sec_ * sample_rate_);
+
+    // Keep the current position in the cycle and move its pending events with it.
+    const float progress = static_cast<float>(sample_clock_ - cycle_start_) / static_cast<float>(old_samples_per_cycle);
+    cycle_start_         = sample_clock_ - static_cast<uint64_t>(progress * static_cast<float>(samples_per_cycle_));
+
+    for(size_t i = 0; i < events_.Size(); i++) {
+        Event& ev = events_.At(i);
+        if(ev.cycle_point < 0.0f) {
+            continue;
+        }
+        ev.time = cycle_start_ + TriggerSample(ev.cycle_point, samples_per_cycle_);
+        if(ev.time < sample_clock_) {
+            ev.time = sample_clock_;
+        }
+    }
+    events_.Sort();
+}
+
+void Engine::ApplyControls() {
+    ControlMessage msg;
+    while(controls_.Peek(msg) && msg.time <= sample_clock_) {
+        controls_.Pop(msg);
+        switch(msg.type) {
+            case CONTROL_BPM:
+                if(msg.value > 0.0f && msg.value != bpm_) {
+                    ApplyTempo(msg.value);
+                }
+                break;
+            case CONTROL_ROOT_NUDGE:
+                sequencer_.RequestNudge();
+                break;
+            case CONTROL_DELAY_TIME:
+                if(msg.value > 0.0f) {
+                    delay_time_sec_ = msg.value;
+                    delay_change_   = delay_time_sec_ * sample_rate_; // applied by the effect stage
+                }
+                break;
+        }
+    }
+}
+
+// Block-rate LED update. Targets match the old per-sample follower's: bus level x4,
+// a gate boost and the effect trail. A per-sample follower with fast attack and slow
+// release settles between a waveform's RMS and its peak, so the block level is the
+// midpoint of the two.
+void Engine::UpdateLeds(uint8_t gates) {
+    static const float led_trail_weight[6] = {0.22f, 0.80f, 0.18f, 0.80f, 0.16f, 0.48f};
+
+    const float trail = Clampf(meter_.TrailPeak() * 0.20f, 0.0f, 1.0f);
+
+    float targets[LedMeter::kBuses];
+    for(int vi = 0; vi < LedMeter::kBuses; vi++) {
+        const float level      = 0.5f * (meter_.Peak(vi) + meter_.Rms(vi));
+        const float gate_boost = (gates >> vi) & 1u ? 0.18f : 0.0f;
+        targets[vi] = Clampf(level * 4.0f + gate_boost + trail * led_trail_weight[vi], 0.0f, 1.0f);
+    }
+    meter_.Follow(targets);
+}
+
+void Engine::PublishMeters(const BlockStatus& status) {
+    MeterSnapshot m;
+    for(int i = 0; i < LedMeter::kBuses; i++) {
+        m.led_levels[i] = meter_.Level(i);
+        m.bus_peak[i]   = meter_.Peak(i);
+        m.bus_rms[i]    = meter_.Rms(i);
+    }
+    m.sample_clock        = status.sample_clock;
+    m.sequencer_underruns = status.sequencer_underruns;
+    m.voices_active       = status.voices_active;
+    m.voice_budget        = status.voice_budget;
+    m.cpu_load            = status.cpu_load;
+    m.voices_shed         = status.voices_shed;
+    meters_.Write(m);
+}
+
+void Engine::DispatchEvents() {
+    while(!events_.Empty() && events_.Front().time <= sample_clock_) {
+        const Event ev = events_.Front();
+        events_.Pop();
+
+        switch(ev.type) {
+            case EVENT_CYCLE_TICK: {
+                PROFILE_SCOPE(profiler_, PROFILE_CYCLE_TICK);
+                ProcessCycleTick();
+                cycle_start_ = sample_clock_;
+                ScheduleCycle();
+                break;
+            }
+            case EVENT_FOLLOWER_TRIGGER: {
+                PROFILE_SCOPE(profiler_, PROFILE_TRIGGERS);
+                TriggerFollower(ev.index);
+                break;
+            }
+            case EVENT_PAD_RELEASE:
+                ReleasePad(ev.index);
+                break;
+        }
+    }
+}
+
+void Engine::AdvanceTriggerLfos(size_t size) {
+    // Stepped per control period rather than per run so the value a trigger sees
+    // does not depend on how the callback was split.
+    uint32_t remaining = static_cast<uint32_t>(size);
+    while(remaining >= trigger_lfo_left_) {
+        remaining -= trigger_lfo_left_;
+        trigger_lfo_left_ = control_period_;
+        sparkle_brightness_lfo_[0].Advance(control_period_);
+        sparkle_brightness_lfo_[1].Advance(control_period_);
+        pad_decay_lfo_.Advance(control_period_);
+    }
+    trigger_lfo_left_ -= remaining;
+}
+
+void Engine::RenderDrones(const VoiceBuses& buses, size_t size) {
+    float* const out[DroneBank::kVoices] = {buses.drone[0], buses.drone[1], buses.drone[2]};
+    drones_.Process(out, size);
+}
+
+// Adds one pooled voice's run to its bus at the slot's (ramping) gain and follows
+// its level for the steal/shed decisions. The follower is per sample, so those
+// decisions do not depend on how the callback was split. Returns true once a
+// shed fade is done.
+template <typename Slot>
+static bool MixPooledVoice(Slot& slot, const float* voice, float* bus, size_t size) {
+    float level = slot.level;
+    float gain  = slot.gain;
+    for(size_t i = 0; i < size; i++) {
+        if(slot.ramp_left > 0) {
+            gain += slot.gain_step;
+            slot.ramp_left--;
+        }
+        level = fmaxf(level * VOICE_LEVEL_DECAY, fabsf(voice[i]));
+        bus[i] += voice[i] * gain;
+    }
+    slot.gain  = gain;
+    slot.level = level;
+    return slot.shedding && slot.ramp_left == 0;
+}
+
+void Engine::RenderSparkles(const VoiceBuses& buses, size_t size) {
+    memset(buses.sparkle[0], 0, sizeof(float) * size);
+    memset(buses.sparkle[1], 0, sizeof(float) * size);
+    for(int v = 0; v < kSparkleVoices; v++) {
+        if(!sparkle_pool_.Active(v)) {
+            continue;
+        }
+        auto& slot = sparkle_pool_[v];
+        sparkles_[v].Render(voice_buf_, size);
+        if(MixPooledVoice(slot, voice_buf_, buses.sparkle[slot.owner], size) || sparkles_[v].asleep) {
+            sparkle_pool_.Free(v);
+        }
+    }
+}
+
+void Engine::RenderPad(const VoiceBuses& buses, size_t size) {
+    memset(buses.pad, 0, sizeof(float) * size);
+    for(int v = 0; v < kPadVoices; v++) {
+        if(!pad_pool_.Active(v)) {
+            continue;
+        }
+        pads_[v].Render(voice_buf_, size, control_period_);
+        if(MixPooledVoice(pad_pool_[v], voice_buf_, buses.pad, size) || pads_[v].Idle()) {
+            pads_[v].env_gate = false;
+            pad_pool_.Free(v);
+        }
+    }
+}
+
+void Engine::RenderSampler(const VoiceBuses& buses, size_t size) {
+    sampler_.Render(buses.sampler, size, control_period_);
+}
+
+void Engine::MixAndDelay(const VoiceBuses& buses, size_t size) {
+    // Runs are shorter than the delay, so the whole run's returns can be read first.
+    delay_->Read(delay_ret_[0], delay_ret_[1], size);
+
+    for(size_t i = 0; i < size; i++) {
+        // Buses are mono until the final mix; summation order matches the per-voice loop.
+        const float drone_bus   = buses.drone[0][i] + buses.drone[1][i] + buses.drone[2][i] + buses.sampler[i];
+        const float sparkle_bus = buses.sparkle[0][i] + buses.sparkle[1][i];
+        const float pad_bus     = buses.pad[i];
+
+        const float delay_input = drone_bus * DRONE_DELAY + sparkle_bus * SPARKLE_DELAY + pad_bus * PAD_DELAY;
+
+        delay_send_[0][i] = delay_input + delay_ret_[0][i] * delay_feedback_;
+        delay_send_[1][i] = delay_input + delay_ret_[1][i] * delay_feedback_;
+
+        drone_bus_[i]   = drone_bus;
+        sparkle_bus_[i] = sparkle_bus;
+    }
+
+    delay_->Write(delay_send_[0], delay_send_[1], size);
+}
+
+static_assert(Engine::kMaxBlockSize <= FdnReverb::kMaxBlock, "a run must fit in one FdnReverb block");
+
+void Engine::RenderReverb(const VoiceBuses& buses, size_t size) {
+    // The inputs are built in reverb_ret_ and replaced by the returns.
+    for(size_t i = 0; i < size; i++) {
+        const float reverb_send = drone_bus_[i] * DRONE_REVERB + sparkle_bus_[i] * SPARKLE_REVERB + buses.pad[i] * PAD_REVERB;
+        reverb_ret_[0][i] = reverb_send + delay_ret_[0][i] * 0.3f;
+        reverb_ret_[1][i] = reverb_send + delay_ret_[1][i] * 0.3f;
+    }
+
+#if defined(AMBIENT_REVERB_FDN)
+    reverb_.Process(reverb_ret_[0], reverb_ret_[1], reverb_ret_[0], reverb_ret_[1], size);
+#else
+    for(size_t i = 0; i < size; i++) {
+        reverb_.Process(reverb_ret_[0][i], reverb_ret_[1][i], &reverb_ret_[0][i], &reverb_ret_[1][i]);
+    }
+#endif
+}
+
+void Engine::MeterAndOutput(const VoiceBuses& buses, float* out, size_t size) {
+    // Bus order matches the LEDs (sequencer voices 0..5).
+    meter_.AccumulateBus(0, buses.drone[0], size);
+    meter_.AccumulateBus(1, buses.sparkle[0], size);
+    meter_.AccumulateBus(2, buses.drone[1], size);
+    meter_.AccumulateBus(3, buses.sparkle[1], size);
+    meter_.AccumulateBus(4, buses.drone[2], size);
+    meter_.AccumulateBus(5, buses.pad, size);
+    meter_.AddFrames(size);
+
+    float trail = 0.0f;
+    for(size_t i = 0; i < size; i++) {
+        const float dry = drone_bus_[i] * DRONE_DRY + sparkle_bus_[i] * SPARKLE_DRY + buses.pad[i] * PAD_DRY;
+
+        const float delay_read_l = delay_ret_[0][i];
+        const float delay_read_r = delay_ret_[1][i];
+        const float rev_l        = reverb_ret_[0][i];
+        const float rev_r        = reverb_ret_[1][i];
+
+        const float final_l = dry + delay_read_l + rev_l;
+        const float final_r = dry + delay_read_r + rev_r;
+
+        trail = fmaxf(trail, fabsf(delay_read_l) + fabsf(delay_read_r) + fabsf(rev_l) + fabsf(rev_r));
+
+        out[i * 2]     = Clampf(final_l, -1.0f, 1.0f);
+        out[i * 2 + 1] = Clampf(final_r, -1.0f, 1.0f);
+    }
+    meter_.AccumulateTrail(trail);
+}
+
+void Engine::RenderVoiceRun(size_t frames, const VoiceBuses& buses, RunRecord& run) {
+    ApplyControls();
+    DispatchEvents();
+
+    // The cycle tick is always pending, so the queue is never empty here.
+    size_t size = static_cast<size_t>(events_.Front().time - sample_clock_);
+
+    // Stop at the next timestamped control message as well.
+    ControlMessage next;
+    if(controls_.Peek(next) && next.time > sample_clock_ && next.time - sample_clock_ < size) {
+        size = static_cast<size_t>(next.time - sample_clock_);
+    }
+    if(size > frames) {
+        size = frames;
+    }
+    if(size > kMaxBlockSize) {
+        size = kMaxBlockSize;
+    }
+
+    ShedVoices();
+    AdvanceTriggerLfos(size);
+
+    run.frames       = static_cast<uint32_t>(size);
+    run.delay_frames = delay_change_;
+    delay_change_    = 0.0f;
+    TakeDroneChanges(run);
+
+    {
+        PROFILE_SCOPE(profiler_, PROFILE_SPARKLES);
+        RenderSparkles(buses, size);
+    }
+    {
+        PROFILE_SCOPE(profiler_, PROFILE_PAD);
+        RenderPad(buses, size);
+    }
+    sample_clock_ += size;
+}
+
+void Engine::RenderLeaderRun(const RunRecord& run, const VoiceBuses& buses) {
+    for(int di = 0; di < 3; di++) {
+        const uint8_t bit = static_cast<uint8_t>(1u << di);
+        if(run.drone_freq_set & bit) {
+            drones_.SetFreq(di, run.drone_freq[di]);
+        }
+        if(run.drone_gate_set & bit) {
+            drones_.SetGate(di, (run.drone_gate & bit) != 0);
+        }
+    }
+    {
+        PROFILE_SCOPE(profiler_, PROFILE_DRONES);
+        RenderDrones(buses, run.frames);
+    }
+    {
+        PROFILE_SCOPE(profiler_, PROFILE_SAMPLER);
+        RenderSampler(buses, run.frames);
+    }
+}
+
+void Engine::RenderEffectRun(const RunRecord& run, const VoiceBuses& buses, float* out) {
+    if(run.delay_frames > 0.0f) {
+        delay_->SetDelay(run.delay_frames);
+    }
+    {
+        PROFILE_SCOPE(profiler_, PROFILE_DELAY);
+        MixAndDelay(buses, run.frames);
+    }
+    {
+        PROFILE_SCOPE(profiler_, PROFILE_REVERB);
+        RenderReverb(buses, run.frames);
+    }
+    {
+        PROFILE_SCOPE(profiler_, PROFILE_METERS);
+        MeterAndOutput(buses, out, run.frames);
+    }
+}
+
+Engine::BlockStatus Engine::VoiceStatus() const {
+    BlockStatus status;
+    status.sample_clock        = sample_clock_;
+    status.sequencer_underruns = sequencer_.Underruns();
+    status.voices_shed         = budget_.ShedTotal();
+    status.cpu_load            = budget_.Load();
+    status.voices_active       = static_cast<uint8_t>(sparkle_pool_.Count() + pad_pool_.Count());
+    status.voice_budget        = static_cast<uint8_t>(budget_.Voices());
+    status.gates               = 0;
+    const turing::SequencerState& seq = sequencer_.Live();
+    for(int vi = 0; vi < LedMeter::kBuses; vi++) {
+        status.gates |= seq.voices[vi].gate ? static_cast<uint8_t>(1u << vi) : 0;
+    }
+    return status;
+}
+
+void Engine::FinishBlock(const BlockStatus& status) {
+    PROFILE_SCOPE(profiler_, PROFILE_METERS);
+    UpdateLeds(status.gates);
+    PublishMeters(status);
+    meter_.Reset();
+}
+
+void Engine::Process(float* out, size_t size) {
+    const ScopedFlushDenormals flush_denormals;
+    PROFILE_BEGIN_CALLBACK(profiler_);
+
+    const VoiceBuses buses = {{drone_buf_[0], drone_buf_[1], drone_buf_[2]},
+                              {sparkle_buf_[0], sparkle_buf_[1]},
+                              pad_buf_,
+                              sampler_buf_};
+
+    size_t frames = size / 2;
+    while(frames > 0) {
+        RunRecord run;
+        RenderVoiceRun(frames, buses, run);
+        RenderLeaderRun(run, buses);
+        RenderEffectRun(run, buses, out);
+        out += run.frames * 2;
+        frames -= run.frames;
+    }
+
+    FinishBlock(VoiceStatus());
+    PROFILE_END_CALLBACK(profiler_);
+}
+
+} // namespace ambient
@@ -0,0 +1,408 @@
+// ambient_engine.h
+// Ambient Turing Machine — Platform-Independent Audio Engine
+// Drones, sparkles, pad, sample layer, delay and reverb driven by turing_sequencer.h.
+// No hardware dependencies: main_daisy.cpp wraps it for the Seed and
+// host/ renders it offline on Linux.
+
+#ifndef AMBIENT_ENGINE_H
+#define AMBIENT_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "control_rate.h"
+#include "daisysp.h"
+#include "drone_bank.h"
+#include "event_queue.h"
+#include "fdn_reverb.h"
+#include "led_meter.h"
+#include "sample_stream.h"
+#include "seqlock.h"
+#include "sequencer_lookahead.h"
+#include "spsc_queue.h"
+#include "stage_profiler.h"
+#include "stereo_delay.h"
+#include "turing_sequencer.h"
+#include "voice_pool.h"
+#include "wavetable.h"
+
+namespace ambient {
+
+// 2 s of interleaved stereo delay memory at 48 kHz (1 s at 96 kHz). The Seed keeps
+// it in SDRAM, so the engine only holds a pointer and the platform decides where it
+// lives. Float by default (768 KB); `make DELAY=int16` or `DELAY=bf16` halve it.
+#if defined(AMBIENT_DELAY_INT16)
+typedef StereoDelay<DelayInt16, 96000> DelayBuffer;
+#elif defined(AMBIENT_DELAY_BF16)
+typedef StereoDelay<DelayBf16, 96000> DelayBuffer;
+#else
+typedef StereoDelay<DelayFloat32, 96000> DelayBuffer;
+#endif
+
+// =============================================
+// VOICE STRUCTURES
+// =============================================
+// Each voice renders a run of mono samples into a caller buffer. The engine owns
+// triggering and the LFOs read at trigger time; host/bench_components drives the
+// voices on their own.
+
+struct SparkleVoice {
+    daisysp::StringVoice string;
+    float                volume;
+    uint32_t             quiet_samples; // consecutive output samples below the silence threshold
+    bool                 asleep;        // decayed to silence; skipped until the next pluck
+
+    void Init(float sample_rate, int index); // index 0/1 selects the parameter set
+    void Configure(int index);               // string character of parameter set `index`
+    void Render(float* out, size_t size);
+};
+
+// The pad's triangles: computed per sample by daisysp, or read from the shared
+// band-limited tables with `make OSC=wavetable`.
+#if defined(AMBIENT_OSC_WAVETABLE)
+typedef WavetableOscillator PadOscillator;
+#else
+typedef daisysp::Oscillator PadOscillator;
+#endif
+
+struct PadVoice {
+    PadOscillator       osc1;
+    PadOscillator       osc2;
+    daisysp::WhiteNoise noise;
+    daisysp::Svf        filter;
+    daisysp::Svf        noise_filter;
+    daisysp::Adsr       env;
+    ControlLfo          vibrato_lfo;
+    LinearRamp          vibrato_ratio;
+    uint32_t            control_left;
+    bool                env_gate;
+    float               target_freq;
+    float               current_freq;
+    float               volume;
+    float               noise_mix;
+    float               vibrato_depth_cents;
+    float               detune_cents;
+    float               sample_rate;
+
+    void Init(float sample_rate);
+
+    // Oscillator phases, noise seed, filter state and vibrato as after Init; applied
+    // whenever a pooled pad voice starts, so its output never depends on what it
+    // played before or when it was freed.
+    void ResetState();
+    bool Idle() const;
+
+    void Render(float* out, size_t size, uint32_t control_period);
+};
+
+// Interpolation between stream samples. Whenever the position is a whole sample
+// and the rate exactly 1, the player copies samples (SAMPLE_INTERP_NONE) instead.
+enum SampleInterp : uint8_t {
+    SAMPLE_INTERP_NONE, // previous sample, no interpolation
+    SAMPLE_INTERP_LINEAR,
+    SAMPLE_INTERP_HERMITE, // 4-point, 3rd order
+};
+
+struct SamplePlayer {
+    SampleStream        stream;    // decoded ahead of position; see sample_stream.h
+    uint64_t            position;  // unwrapped stream position, 32.32 fixed point
+    uint64_t            increment; // playback rate, 32.32 fixed point
+    SampleInterp        interp;
+    RampedSvf           filter;
+    ControlLfo          filter_lfo;
+    uint32_t            control_left;
+    float               base_filter_freq;
+    float               lfo_depth;
+    float               volume;
+
+    void Init(float sample_rate);
+    void SetPlaybackRate(float rate); // 0 < rate <= 4
+    // size * rate must stay below 512 so the stream ring covers the run.
+    void Render(float* out, size_t size, uint32_t control_period);
+
+  private:
+    template <SampleInterp Mode>
+    void RenderRun(float* out, size_t n);
+};
+
+// =============================================
+// CONTROL MESSAGES AND METERS
+// =============================================
+
+enum ControlType : uint8_t {
+    CONTROL_BPM,        // value: tempo in BPM
+    CONTROL_ROOT_NUDGE, // next circle-of-fifths root at the following cycle boundary
+    CONTROL_DELAY_TIME, // value: delay time in seconds; the repeats glide there
+};
+
+// Parameter change from the main loop. Applied at the first run boundary at or
+// after `time` (engine sample clock); 0 means as soon as possible.
+struct ControlMessage {
+    uint64_t    time;
+    ControlType type;
+    float       value;
+};
+
+// Published by the audio thread at the end of every Process call. Bus levels
+// cover that call only; all fields come from the same call.
+struct MeterSnapshot {
+    float    led_levels[6];       // smoothed LED brightness 0..1 per sequencer voice
+    float    bus_peak[6];         // per-voice bus |x| peak, in LED order
+    float    bus_rms[6];          // per-voice bus RMS, in LED order
+    uint64_t sample_clock;        // samples rendered so far
+    uint32_t sequencer_underruns; // cycle ticks that ran inline (see PrepareNextCycle)
+    uint8_t  voices_active;       // sparkle + pad voices playing
+    uint8_t  voice_budget;        // voices the CPU budget currently allows
+    float    cpu_load;            // followed callback load the budget acts on
+    uint32_t voices_shed;         // budget reductions since Init
+};
+
+// =============================================
+// ENGINE
+// =============================================
+
+class Engine {
+  public:
+    // Longest run rendered in one pass. Callback blocks are split at this size
+    // and at sequencer events (cycle tick, follower triggers, pad release).
+    static const size_t kMaxBlockSize = 128;
+
+    // Follower voice pools. By default each sparkle follower retriggers its own
+    // string and the pad one voice. With VOICES=layered each trigger takes fresh
+    // voices while earlier ones ring out, and the pad plays PAD_LAYERS detuned
+    // voices per trigger.
+#if defined(AMBIENT_VOICES_LAYERED)
+    static const int kSparkleVoices = 4;
+    static const int kPadVoices     = 6;
+#else
+    static const int kSparkleVoices = 2;
+    static const int kPadVoices     = 1;
+#endif
+
+    Engine() {}
+    ~Engine() {}
+
+    // Delay memory is owned by the caller (SDRAM on the Seed, heap or BSS on the host).
+    // start_root is the circle-of-fifths position (0 = C, 1 = G, ...) the sequence
+    // starts from, the same as that many root nudges before audio starts.
+    // start_cycle starts it that many cycles in, with the sequencer state a run from
+    // the start would have reached (the seek takes constant time); the lead-in
+    // before the first tick then plays the followers of the cycle before.
+    void Init(float sample_rate, DelayBuffer* delay, int start_root = 0, uint32_t start_cycle = 0);
+
+    // Renders interleaved stereo. Same convention as the libDaisy interleaving
+    // callback: size counts samples across both channels (frames * 2).
+    void Process(float* out, size_t size);
+
+    // ---- Staged processing ----
+    // Process() runs these three stages back to back for each run. Each stage owns
+    // its own state, so a host pipeline (host/pipelined_engine.h) can run them on
+    // separate threads and still produce bit-identical output:
+    //   voice stage  (controls, events, sparkles, pad)  RenderVoiceRun, VoiceStatus
+    //   leader stage (drones, sampler)                  RenderLeaderRun
+    //   effect stage (delay, reverb, meters, output)    RenderEffectRun, FinishBlock
+    // Leaders and effects replay what the voice stage recorded for the run.
+
+    // Mono bus buffers of one run, written by the voice and leader stages.
+    struct VoiceBuses {
+        float* drone[3];
+        float* sparkle[2];
+        float* pad;
+        float* sampler;
+    };
+
+    // What the voice stage decided for one run.
+    struct RunRecord {
+        uint32_t frames;
+        uint8_t  drone_freq_set; // bit per drone: SetFreq(drone_freq) before the run
+        uint8_t  drone_gate_set; // bit per drone: SetGate(drone_gate bit) before the run
+        uint8_t  drone_gate;
+        float    drone_freq[3];
+        float    delay_frames; // new delay time, or 0 to keep it
+    };
+
+    // Voice-stage state published with the meters at the end of a callback.
+    struct BlockStatus {
+        uint64_t sample_clock;
+        uint32_t sequencer_underruns;
+        uint32_t voices_shed;
+        float    cpu_load;
+        uint8_t  voices_active;
+        uint8_t  voice_budget;
+        uint8_t  gates; // bit per sequencer voice
+    };
+
+    // Renders the next run (at most `frames`, at most kMaxBlockSize) of the
+    // sparkle and pad buses and fills `run`.
+    void RenderVoiceRun(size_t frames, const VoiceBuses& buses, RunRecord& run);
+    // Renders the drone and sampler buses of a recorded run.
+    void RenderLeaderRun(const RunRecord& run, const VoiceBuses& buses);
+    // Mixes a rendered run through the delay and reverb into interleaved `out`.
+    void RenderEffectRun(const RunRecord& run, const VoiceBuses& buses, float* out);
+    // Taken by the voice stage after a callback's last run.
+    BlockStatus VoiceStatus() const;
+    // Updates the LEDs and publishes the meters for a callback's worth of runs.
+    void FinishBlock(const BlockStatus& status);
+
+    // Control input from the main loop (single producer). Returns false when the
+    // queue is full; the caller keeps its value and retries later.
+    static const uint32_t kControlQueueSize = 32;
+    bool                  PostControl(const ControlMessage& msg) { return controls_.Push(msg); }
+
+    // Tempo in BPM; one sequencer cycle is four beats. The rest of the current cycle
+    // is rescheduled so pending triggers keep their position in the cycle.
+    bool SetBpm(float bpm) { return PostControl(ControlMessage{0, CONTROL_BPM, bpm}); }
+
+    // Advance the root to the next circle-of-fifths position at the next cycle boundary.
+    bool RequestRootNudge() { return PostControl(ControlMessage{0, CONTROL_ROOT_NUDGE, 0.0f}); }
+
+    // Left delay time in seconds (the right channel stays 18 ms longer). Changes glide
+    // at the delay's slew rate instead of jumping.
+    bool SetDelayTime(float seconds) { return PostControl(ControlMessage{0, CONTROL_DELAY_TIME, seconds}); }
+
+    // Load of the callback that just ran: render time / (frames / sample rate).
+    // Call from the audio callback after Process. Above 80% the engine fades out
+    // its quietest follower voices and lowers the voice count until the load falls;
+    // without reports every voice stays available and rendering is deterministic.
+    void ReportLoad(float load) { budget_.Report(load); }
+
+    // Samples between LFO/filter modulation updates (default kDefaultControlPeriod).
+    // Modulated parameters glide linearly between updates.
+    void     SetControlPeriod(uint32_t samples);
+    uint32_t ControlPeriod() const { return control_period_; }
+
+    // Computes the next sequencer cycle ahead of the audio thread. Call regularly from
+    // the main loop (or another lower-priority context than Process); returns true
+    // when a cycle was prepared. Cycles not prepared in time are ticked inside Process.
+    bool PrepareNextCycle() { return sequencer_.Prepare(); }
+
+    // Consistent copy of the latest meters; safe from any thread.
+    MeterSnapshot Meters() const { return meters_.Read(); }
+
+    const turing::SequencerState& Sequencer() const { return sequencer_.Live(); }
+    float                         SampleRate() const { return sample_rate_; }
+    float                         Bpm() const { return bpm_; }
+    uint32_t                      SamplesPerCycle() const { return samples_per_cycle_; }
+
+#if defined(AMBIENT_PROFILE)
+    // Per-stage timing of Process; the main loop calls TakeReport on it.
+    StageProfiler& Profiler() { return profiler_; }
+#endif
+
+  private:
+    void ProcessCycleTick();
+    // Drone changes for the run about to render: the ticks since the last run.
+    void TakeDroneChanges(RunRecord& run);
+    void TriggerFollower(int follower);
+    void TriggerSparkle(int follower, float freq);
+    void TriggerPad(float freq);
+    void ReleasePad(uint8_t group);
+
+    // Fades out the quietest follower voices while more play than the budget allows.
+    void ShedVoices();
+
+    // Queues the follower triggers and the closing tick of the cycle starting at cycle_start_.
+    void ScheduleCycle();
+    void ApplyTempo(float bpm);
+
+    // Applies every queued control message that is due at sample_clock_.
+    void ApplyControls();
+    void UpdateLeds(uint8_t gates);
+    void PublishMeters(const BlockStatus& status);
+
+    // Runs every event due at sample_clock_.
+    void DispatchEvents();
+
+    // Steps the LFOs that are only read on a trigger (sparkle brightness, pad decay).
+    void AdvanceTriggerLfos(size_t size);
+
+    // Voice renderers write `size` mono samples into their bus buffers.
+    void RenderDrones(const VoiceBuses& buses, size_t size);
+    void RenderSparkles(const VoiceBuses& buses, size_t size);
+    void RenderPad(const VoiceBuses& buses, size_t size);
+    void RenderSampler(const VoiceBuses& buses, size_t size);
+
+    // Mixer and effects, one pass each so they can be timed separately:
+    // sums the buses and runs the delay pair, runs the reverb, then updates LED
+    // levels and writes the interleaved output.
+    void MixAndDelay(const VoiceBuses& buses, size_t size);
+    void RenderReverb(const VoiceBuses& buses, size_t size);
+    void MeterAndOutput(const VoiceBuses& buses, float* out, size_t size);
+
+    // Milliseconds of audio rendered since Init; seeds the sparkle velocity spread.
+    uint32_t ElapsedMs() const;
+
+    DroneBank    drones_;
+    SparkleVoice sparkles_[kSparkleVoices];
+    PadVoice     pads_[kPadVoices];
+    SamplePlayer sampler_;
+
+    VoicePool<kSparkleVoices> sparkle_pool_; // owner: follower 0/1
+    VoicePool<kPadVoices>     pad_pool_;     // owner: follower 2
+    CpuBudget                 budget_;
+    uint8_t                   next_group_;
+
+    // Read when a follower triggers; stepped by AdvanceTriggerLfos.
+    ControlLfo sparkle_brightness_lfo_[2];
+    ControlLfo pad_decay_lfo_;
+
+#if defined(AMBIENT_REVERB_FDN)
+    FdnReverb              reverb_; // `make REVERB=fdn`; same controls, a fraction of the cost
+#else
+    daisysp::ReverbSc      reverb_;
+#endif
+    DelayBuffer*           delay_;
+    SequencerLookahead     sequencer_;
+
+    float    sample_rate_;
+    float    cycle_duration_sec_;
+    uint32_t samples_per_cycle_;
+    uint64_t cycle_start_;
+    uint64_t sample_clock_;
+    uint32_t control_period_;
+    uint32_t trigger_lfo_left_;
+    float    bpm_;
+
+    // Drone pitch and gate as the sequencer last set them, and the changes not yet
+    // handed to the leader stage (see TakeDroneChanges).
+    float     drone_freq_[3];
+    uint8_t   drone_gate_;
+    RunRecord drone_changes_;
+    float     delay_change_; // delay frames from a control, 0 once handed over
+
+    EventQueue events_;
+
+    SpscQueue<ControlMessage, kControlQueueSize> controls_;
+    SeqlockSnapshot<MeterSnapshot>               meters_;
+
+    float reverb_feedback_;
+    float reverb_lpfreq_;
+    float delay_time_sec_;
+    float delay_feedback_;
+
+    // Per-voice output for the current run; the mixer reads these afterwards.
+    // Sparkle and pad buffers hold each follower's voices summed. Process renders
+    // into these; the host pipeline brings its own (VoiceBuses).
+    float drone_buf_[3][kMaxBlockSize];
+    float sparkle_buf_[2][kMaxBlockSize];
+    float pad_buf_[kMaxBlockSize];
+    float sampler_buf_[kMaxBlockSize];
+    float voice_buf_[kMaxBlockSize]; // one pooled voice before it is mixed into its bus
+
+    // Mixer intermediates for the current run.
+    float drone_bus_[kMaxBlockSize];
+    float sparkle_bus_[kMaxBlockSize];
+    float delay_ret_[2][kMaxBlockSize];
+    float delay_send_[2][kMaxBlockSize]; // input + feedback written back to the delay
+    float reverb_ret_[2][kMaxBlockSize];
+
+    LedMeter meter_; // bus levels of the current Process call, LED follower
+
+#if defined(AMBIENT_PROFILE)
+    StageProfiler profiler_;
+#endif
+};
+
+} // namespace ambient
+
+#endif // AMBIENT_ENGINE_H
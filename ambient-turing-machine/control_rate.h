@@ -0,0 +1,175 @@
+// control_rate.h
+// Control-Rate Modulation — LFOs and Filter Coefficients Updated Every N Samples
+// The patch's LFOs move at 0.01-5 Hz, so evaluating them (and recomputing SVF
+// coefficients from them) at audio rate is wasted work. These helpers evaluate
+// at a control period and interpolate linearly between updates.
+// Header-only, no DaisySP dependency.
+
+#ifndef CONTROL_RATE_H
+#define CONTROL_RATE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+// Samples between control updates unless the engine is told otherwise.
+static const uint32_t kDefaultControlPeriod = 32;
+
+// =============================================
+// CONTROL LFO
+// =============================================
+
+// Same phase convention and waveforms as daisysp::Oscillator (phase 0..1,
+// WAVE_TRI / WAVE_SIN, amplitude 1), but advanced by arbitrary sample counts.
+class ControlLfo {
+  public:
+    enum Shape {
+        SHAPE_TRI,
+        SHAPE_SIN,
+    };
+
+    void Init(float sample_rate, Shape shape, float freq) {
+        shape_ = shape;
+        inc_   = freq / sample_rate;
+        phase_ = 0.0f;
+    }
+
+    float Value() const {
+        if(shape_ == SHAPE_SIN) {
+            return sinf(phase_ * 6.28318530717958647692f);
+        }
+        const float t = -1.0f + (2.0f * phase_);
+        return 2.0f * (fabsf(t) - 0.5f);
+    }
+
+    void Advance(size_t samples) {
+        phase_ += inc_ * static_cast<float>(samples);
+        phase_ -= static_cast<float>(static_cast<int32_t>(phase_));
+    }
+
+    // Value at the current phase, then advance; Process(1) mirrors Oscillator::Process().
+    float Process(size_t samples) {
+        const float v = Value();
+        Advance(samples);
+        return v;
+    }
+
+  private:
+    Shape shape_;
+    float phase_;
+    float inc_;
+};
+
+// =============================================
+// LINEAR RAMP
+// =============================================
+
+// A value that glides to each new target over one control period.
+class LinearRamp {
+  public:
+    void Reset(float value) {
+        value_ = value;
+        step_  = 0.0f;
+    }
+
+    void SetTarget(float target, uint32_t samples) {
+        step_ = (target - value_) / static_cast<float>(samples);
+    }
+
+    float Next() {
+        value_ += step_;
+        return value_;
+    }
+
+    float Value() const { return value_; }
+
+  private:
+    float value_;
+    float step_;
+};
+
+// =============================================
+// RAMPED SVF
+// =============================================
+
+// Two-pass state-variable lowpass with the same math as daisysp::Svf, whose
+// frequency/damping coefficients glide to each new cutoff over a control period
+// instead of being recomputed (sinf + powf) every sample.
+class RampedSvf {
+  public:
+    void Init(float sample_rate, float res) {
+        sample_rate_ = sample_rate;
+        res          = res < 0.0f ? 0.0f : (res > 1.0f ? 1.0f : res);
+        res_damp_    = 2.0f * (1.0f - powf(res, 0.25f));
+        drive_       = 0.5f * res;
+        low_         = 0.0f;
+        band_        = 0.0f;
+        out_low_     = 0.0f;
+        out_band_    = 0.0f;
+    }
+
+    // Jump straight to a cutoff (initial state).
+    void SetFreq(float freq) {
+        float f, damp;
+        Coefficients(freq, f, damp);
+        freq_.Reset(f);
+        damp_.Reset(damp);
+    }
+
+    // Glide to a cutoff over `samples` calls to Process().
+    void SetFreqTarget(float freq, uint32_t samples) {
+        float f, damp;
+        Coefficients(freq, f, damp);
+        freq_.SetTarget(f, samples);
+        damp_.SetTarget(damp, samples);
+    }
+
+    void Process(float in) {
+        const float f    = freq_.Next();
+        const float damp = damp_.Next();
+
+        float notch = in - damp * band_;
+        low_        = low_ + f * band_;
+        float high  = notch - low_;
+        band_       = f * high + band_ - drive_ * band_ * band_ * band_;
+        out_low_    = 0.5f * low_;
+        out_band_   = 0.5f * band_;
+
+        notch = in - damp * band_;
+        low_  = low_ + f * band_;
+        high  = notch - low_;
+        band_ = f * high + band_ - drive_ * band_ * band_ * band_;
+        out_low_ += 0.5f * low_;
+        out_band_ += 0.5f * band_;
+    }
+
+    float Low() const { return out_low_; }
+    float Band() const { return out_band_; }
+
+  private:
+    void Coefficients(float freq, float& f, float& damp) const {
+        const float fc_max = sample_rate_ / 3.0f;
+        float       fc     = freq < 1.0e-6f ? 1.0e-6f : (freq > fc_max ? fc_max : freq);
+        float       x      = fc / (sample_rate_ * 2.0f);
+        x                  = x < 0.25f ? x : 0.25f;
+        f                  = 2.0f * sinf(3.1415927410125732421875f * x);
+        const float limit  = 2.0f / f - f * 0.5f;
+        damp               = fminf(res_damp_, fminf(2.0f, limit));
+    }
+
+    float      sample_rate_;
+    float      res_damp_;
+    float      drive_;
+    float      low_;
+    float      band_;
+    float      out_low_;
+    float      out_band_;
+    LinearRamp freq_;
+    LinearRamp damp_;
+};
+
+} // namespace ambient
+
+#endif // CONTROL_RATE_H
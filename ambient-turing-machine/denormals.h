@@ -0,0 +1,53 @@
+// denormals.h
+// Denormal Guard — Flush-to-Zero While the Engine Renders
+// Reverb, delay and filter tails decay into subnormal floats, which x86 handles in
+// microcode at many times the normal cost; a long render slows down badly once the
+// voices go quiet. The guard sets FTZ/DAZ (x86) or FZ (aarch64) for its scope and
+// restores the caller's mode afterwards.
+// The Cortex-M7 FPU handles subnormals at full speed, so it is a no-op on the Seed.
+
+#ifndef DENORMALS_H
+#define DENORMALS_H
+
+#include <cstdint>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace ambient {
+
+class ScopedFlushDenormals {
+  public:
+#if defined(__SSE__)
+    ScopedFlushDenormals() : saved_(_mm_getcsr()) {
+        _mm_setcsr(saved_ | 0x8040u); // FTZ (bit 15) | DAZ (bit 6)
+    }
+    ~ScopedFlushDenormals() { _mm_setcsr(saved_); }
+
+  private:
+    uint32_t saved_;
+#elif defined(__aarch64__)
+    ScopedFlushDenormals() {
+        uint64_t fpcr;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+        saved_ = fpcr;
+        fpcr |= (1ull << 24); // FZ
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+    }
+    ~ScopedFlushDenormals() { __asm__ __volatile__("msr fpcr, %0" : : "r"(saved_)); }
+
+  private:
+    uint64_t saved_;
+#else
+    ScopedFlushDenormals() {}
+    ~ScopedFlushDenormals() {}
+#endif
+
+    ScopedFlushDenormals(const ScopedFlushDenormals&)            = delete;
+    ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+};
+
+} // namespace ambient
+
+#endif // DENORMALS_H
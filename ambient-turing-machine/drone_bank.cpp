@@ -0,0 +1,481 @@
+#include "drone_bank.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "control_rate.h"
+#include "fast_math.h"
+#if defined(AMBIENT_OSC_WAVETABLE)
+#include "wavetable.h"
+#endif
+
+namespace ambient {
+
+// daisysp ADSR_SEG_* values, kept as floats so lane compares stay in the FPU.
+static const float kEnvIdle    = 0.0f;
+static const float kEnvAttack  = 1.0f;
+static const float kEnvDecay   = 2.0f;
+static const float kEnvRelease = 4.0f;
+
+static const float kPi = 3.1415927410125732421875f;
+
+const DroneParams kDroneParams[DroneBank::kVoices] = {
+    {2.5f, 0.5f, 1.0f, 4.0f, 900.0f, 0.18f, 8.0f, 0.25f, 0.06f, 80.0f},
+    {2.5f, 0.5f, 1.0f, 4.0f, 850.0f, 0.15f, 6.0f, 0.20f, 0.045f, 60.0f},
+    {2.5f, 0.5f, 1.0f, 4.0f, 800.0f, 0.12f, 5.0f, 0.13f, 0.08f, 50.0f},
+};
+
+// =============================================
+// LANE TYPES
+// =============================================
+// GCC vector extensions: SSE/AVX on x86 hosts, NEON on aarch64. On the
+// Cortex-M7 there is no float SIMD, so each lane runs the kernel as a float.
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define DRONE_BANK_VECTOR 1
+typedef float F4 __attribute__((vector_size(16)));
+#if defined(__AVX__)
+#define DRONE_BANK_AVX 1
+typedef float F8 __attribute__((vector_size(32)));
+#endif
+#endif
+
+template <typename V>
+static inline V Splat(float x) {
+    return V{} + x;
+}
+
+template <typename V>
+static inline V Load(const float* p) {
+    V v;
+    memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template <typename V>
+static inline void Store(float* p, V v) {
+    memcpy(p, &v, sizeof(V));
+}
+
+template <typename V>
+static inline V Min(V a, V b) {
+    return a < b ? a : b;
+}
+
+template <typename V>
+static inline V Max(V a, V b) {
+    return a > b ? a : b;
+}
+
+template <typename V>
+static inline V Abs(V a) {
+    return a < 0.0f ? -a : a;
+}
+
+// sin(x) for |x| <= pi/4 (the SVF never asks for more). Taylor to x^9, |err| < 1e-7.
+template <typename V>
+static inline V SinPoly(V x) {
+    const V x2 = x * x;
+    V p = Splat<V>(1.0f / 362880.0f);
+    p = p * x2 - (1.0f / 5040.0f);
+    p = p * x2 + (1.0f / 120.0f);
+    p = p * x2 - (1.0f / 6.0f);
+    return x + x * x2 * p;
+}
+
+// daisysp::Oscillator WAVE_POLYBLEP_SAW, amp 1; advances phase.
+template <typename V>
+static inline V PolyBlepSaw(V& phase, V inc, V inv_inc) {
+    const V t      = phase;
+    const V lo_t   = t * inv_inc;
+    const V lo     = lo_t + lo_t - lo_t * lo_t - 1.0f;
+    const V hi_t   = (t - 1.0f) * inv_inc;
+    const V hi     = hi_t * hi_t + hi_t + hi_t + 1.0f;
+    const V blep   = t < inc ? lo : (t > 1.0f - inc ? hi : Splat<V>(0.0f));
+    const V out    = -(((2.0f * t) - 1.0f) - blep);
+    const V next   = phase + inc;
+    phase          = next > 1.0f ? next - 1.0f : next;
+    return out;
+}
+
+#if defined(AMBIENT_OSC_WAVETABLE)
+// Band-limited saw read from each lane's table level; advances phase like
+// PolyBlepSaw. Index and blend stay in V; only the two table loads are per lane
+// (SSE/NEON have no gather). `length` holds each lane's table length as a float.
+template <typename V>
+static inline V TableSaw(V& phase, V inc, const float* const* table, const float* length) {
+    const size_t kN = sizeof(V) / sizeof(float);
+    const V      x  = phase * Load<V>(length);
+    float        xs[kN];
+    float        a[kN];
+    float        b[kN];
+    memcpy(xs, &x, sizeof(V));
+    for(size_t l = 0; l < kN; l++) {
+        const uint32_t idx = static_cast<uint32_t>(xs[l]);
+        a[l]               = table[l][idx];
+        b[l]               = table[l][idx + 1];
+        xs[l]              = static_cast<float>(idx);
+    }
+    const V frac = x - Load<V>(xs);
+    const V lo   = Load<V>(a);
+    const V out  = lo + (Load<V>(b) - lo) * frac;
+    const V next = phase + inc;
+    phase        = next > 1.0f ? next - 1.0f : next;
+    return out;
+}
+#endif
+
+// daisysp::Oscillator WAVE_TRI, amp 1; advances phase.
+template <typename V>
+static inline V Triangle(V& phase, V inc) {
+    const V t    = -1.0f + (2.0f * phase);
+    const V out  = 2.0f * (Abs(t) - 0.5f);
+    const V next = phase + inc;
+    phase        = next > 1.0f ? next - 1.0f : next;
+    return out;
+}
+
+// Cutoff (Hz) -> daisysp::Svf::SetFreq coefficients.
+template <typename V>
+static inline void SvfCoefficients(V cutoff, V res_damp, float sample_rate, V& freq, V& damp) {
+    const V fc = Min(Max(cutoff, Splat<V>(1.0e-6f)), Splat<V>(sample_rate / 3.f));
+    freq       = 2.0f * SinPoly(Min(Splat<V>(kPi * 0.25f), fc * (kPi / (sample_rate * 2.0f))));
+    damp       = Min(res_damp, Min(Splat<V>(2.0f), 2.0f / freq - freq * 0.5f));
+}
+
+template <typename V>
+static inline V ModulatedCutoff(V lfo_val, V base_cutoff, V lfo_depth) {
+    return Max(Splat<V>(200.0f), Min(Splat<V>(2000.0f), base_cutoff + (lfo_val * lfo_depth)));
+}
+
+template <typename V>
+static inline void StoreLanes(V v, float* const out[DroneBank::kVoices], int lane, size_t i) {
+    float lanes[sizeof(V) / sizeof(float)];
+    memcpy(lanes, &v, sizeof(V));
+    for(int l = 0; l < DroneBank::kVoices; l++) {
+        out[l][i] = lanes[l];
+    }
+    (void)lane;
+}
+
+template <>
+inline void StoreLanes<float>(float v, float* const out[DroneBank::kVoices], int lane, size_t i) {
+    out[lane][i] = v;
+}
+
+// =============================================
+// SETUP
+// =============================================
+
+void DroneBank::Init(float sample_rate, const DroneParams params[kVoices]) {
+    sample_rate_    = sample_rate;
+    sr_recip_       = 1.0f / sample_rate;
+    control_period_ = kDefaultControlPeriod;
+    control_left_   = 0;
+
+#if defined(AMBIENT_OSC_WAVETABLE)
+    SharedWavetables().Init();
+#endif
+
+    // daisysp::Adsr keeps its rate as an integer.
+    const float env_rate = static_cast<float>(static_cast<int>(sample_rate));
+
+    for(int l = 0; l < kLanes; l++) {
+        // The padding lane runs silent with harmless values so vector math stays finite.
+        const bool        active = l < kVoices;
+        const DroneParams p      = active ? params[l] : params[0];
+
+        freq_[l]         = 130.81f;
+        detune_ratio_[l] = fastmath::cents_to_ratio(p.detune_cents);
+        gate_[l]         = false;
+        prev_gate_[l]    = false;
+
+        osc_phase_[l]          = 0.0f;
+        osc_phase_[l + kLanes] = 0.0f;
+        SetFreq(l, freq_[l]);
+
+        lfo_phase_[l]   = 0.0f;
+        lfo_inc_[l]     = p.lfo_rate * sr_recip_;
+        base_cutoff_[l] = p.filter_freq;
+        lfo_depth_[l]   = p.lfo_depth;
+
+        const float res  = fminf(fmaxf(p.filter_res, 0.0f), 1.0f);
+        svf_low_[l]      = 0.0f;
+        svf_band_[l]     = 0.0f;
+        svf_res_damp_[l] = 2.0f * (1.0f - powf(res, 0.25f));
+        svf_drive_[l]    = 0.5f * res;
+
+        // Start on the cutoff the first update will ask for (LFO triangle at phase 0 is +1).
+        SvfCoefficients<float>(ModulatedCutoff<float>(1.0f, p.filter_freq, p.lfo_depth),
+                               svf_res_damp_[l], sample_rate_, svf_freq_[l], svf_damp_[l]);
+        svf_freq_step_[l] = 0.0f;
+        svf_damp_step_[l] = 0.0f;
+
+        const float attack_target = 1.01f;
+        const float decay_target  = logf(1. / M_E);
+        env_x_[l]             = 0.0f;
+        env_mode_[l]          = kEnvIdle;
+        env_attack_target_[l] = attack_target;
+        env_attack_d0_[l]     = 1.f - expf(logf(1.f - (1.f / attack_target)) / (p.attack * env_rate));
+        env_decay_d0_[l]      = 1.f - expf(decay_target / (p.decay * env_rate));
+        env_release_d0_[l]    = 1.f - expf(decay_target / (p.release * env_rate));
+        env_sustain_[l]       = p.sustain;
+
+        volume_[l] = active ? p.volume : 0.0f;
+    }
+}
+
+void DroneBank::SetControlPeriod(uint32_t samples) {
+    control_period_ = samples > 0 ? samples : 1;
+    if(control_left_ > control_period_) {
+        control_left_ = control_period_;
+    }
+}
+
+void DroneBank::SetFreq(int voice, float freq) {
+    freq_[voice]                = freq;
+    osc_inc_[voice]             = freq * sr_recip_;
+    osc_inc_[voice + kLanes]    = (freq * detune_ratio_[voice]) * sr_recip_;
+    osc_inv_inc_[voice]         = 1.0f / osc_inc_[voice];
+    osc_inv_inc_[voice + kLanes] = 1.0f / osc_inc_[voice + kLanes];
+#if defined(AMBIENT_OSC_WAVETABLE)
+    const Wavetables& tables = SharedWavetables();
+    for(int o = voice; o < kLanes * 2; o += kLanes) {
+        const int level = Wavetables::LevelFor(osc_inc_[o]);
+        osc_table_[o]   = tables.Table(Wavetables::SHAPE_SAW, level);
+        osc_length_[o]  = static_cast<float>(Wavetables::Length(level));
+    }
+#endif
+}
+
+// =============================================
+// KERNEL
+// =============================================
+
+template <typename V>
+uint32_t DroneBank::ProcessLanes(int lane, float* const out[kVoices], size_t size) {
+    V lfo_phase  = Load<V>(lfo_phase_ + lane);
+    V svf_low    = Load<V>(svf_low_ + lane);
+    V svf_band   = Load<V>(svf_band_ + lane);
+    V freq       = Load<V>(svf_freq_ + lane);
+    V damp       = Load<V>(svf_damp_ + lane);
+    V freq_step  = Load<V>(svf_freq_step_ + lane);
+    V damp_step  = Load<V>(svf_damp_step_ + lane);
+    V env_x      = Load<V>(env_x_ + lane);
+    V env_mode   = Load<V>(env_mode_ + lane);
+
+    const V base_cutoff   = Load<V>(base_cutoff_ + lane);
+    const V lfo_depth     = Load<V>(lfo_depth_ + lane);
+    const V res_damp      = Load<V>(svf_res_damp_ + lane);
+    const V drive         = Load<V>(svf_drive_ + lane);
+    const V attack_d0     = Load<V>(env_attack_d0_ + lane);
+    const V attack_target = Load<V>(env_attack_target_ + lane);
+    const V decay_d0      = Load<V>(env_decay_d0_ + lane);
+    const V release_d0    = Load<V>(env_release_d0_ + lane);
+    const V sustain       = Load<V>(env_sustain_ + lane);
+    const V volume        = Load<V>(volume_ + lane);
+
+    // One LFO step per control period.
+    const float period     = static_cast<float>(control_period_);
+    const float inv_period = 1.0f / period;
+    const V     lfo_inc    = Load<V>(lfo_inc_ + lane) * period;
+
+#if DRONE_BANK_AVX
+    F8       osc_phase   = Load<F8>(osc_phase_);
+    const F8 osc_inc     = Load<F8>(osc_inc_);
+#if !defined(AMBIENT_OSC_WAVETABLE)
+    const F8 osc_inv_inc = Load<F8>(osc_inv_inc_);
+#endif
+#else
+    V       osc1_phase   = Load<V>(osc_phase_ + lane);
+    V       osc2_phase   = Load<V>(osc_phase_ + kLanes + lane);
+    const V osc1_inc     = Load<V>(osc_inc_ + lane);
+    const V osc2_inc     = Load<V>(osc_inc_ + kLanes + lane);
+#if !defined(AMBIENT_OSC_WAVETABLE)
+    const V osc1_inv_inc = Load<V>(osc_inv_inc_ + lane);
+    const V osc2_inv_inc = Load<V>(osc_inv_inc_ + kLanes + lane);
+#endif
+#endif
+
+    uint32_t left = control_left_;
+    size_t   i    = 0;
+    while(i < size) {
+        if(left == 0) {
+            // Cutoff modulation at control rate; the coefficients glide to the
+            // new target over the coming period.
+            const V lfo_val = Triangle(lfo_phase, lfo_inc);
+            V       target_freq, target_damp;
+            SvfCoefficients(ModulatedCutoff(lfo_val, base_cutoff, lfo_depth), res_damp, sample_rate_,
+                            target_freq, target_damp);
+            freq_step = (target_freq - freq) * inv_period;
+            damp_step = (target_damp - damp) * inv_period;
+            left      = control_period_;
+        }
+
+        const size_t n   = size - i < left ? size - i : left;
+        const size_t end = i + n;
+        left -= static_cast<uint32_t>(n);
+
+        for(; i < end; i++) {
+            freq += freq_step;
+            damp += damp_step;
+
+#if DRONE_BANK_AVX
+            union {
+                F8 all;
+                F4 half[2];
+            } saws;
+#if defined(AMBIENT_OSC_WAVETABLE)
+            saws.all = TableSaw(osc_phase, osc_inc, osc_table_, osc_length_);
+#else
+            saws.all = PolyBlepSaw(osc_phase, osc_inc, osc_inv_inc);
+#endif
+            const V osc = (saws.half[0] + saws.half[1]) * 0.5f;
+#else
+#if defined(AMBIENT_OSC_WAVETABLE)
+            const V osc = (TableSaw(osc1_phase, osc1_inc, osc_table_ + lane, osc_length_ + lane)
+                           + TableSaw(osc2_phase, osc2_inc, osc_table_ + kLanes + lane, osc_length_ + kLanes + lane))
+                          * 0.5f;
+#else
+            const V osc = (PolyBlepSaw(osc1_phase, osc1_inc, osc1_inv_inc)
+                           + PolyBlepSaw(osc2_phase, osc2_inc, osc2_inv_inc)) * 0.5f;
+#endif
+#endif
+
+            // Two-pass SVF lowpass, as daisysp::Svf::Process.
+            V notch = osc - damp * svf_band;
+            svf_low = svf_low + freq * svf_band;
+            V high  = notch - svf_low;
+            svf_band = freq * high + svf_band - drive * svf_band * svf_band * svf_band;
+            V low    = 0.5f * svf_low;
+            notch    = osc - damp * svf_band;
+            svf_low  = svf_low + freq * svf_band;
+            high     = notch - svf_low;
+            svf_band = freq * high + svf_band - drive * svf_band * svf_band * svf_band;
+            low += 0.5f * svf_low;
+
+            // daisysp::Adsr::Process with the gate edge already applied.
+            const auto idle      = env_mode == kEnvIdle;
+            const auto attacking = env_mode == kEnvAttack;
+            const V    d0        = env_mode == kEnvDecay ? decay_d0 : (env_mode == kEnvRelease ? release_d0 : attack_d0);
+            const V    target    = attacking ? attack_target : (env_mode == kEnvDecay ? sustain : Splat<V>(-0.01f));
+            const V    next      = env_x + d0 * (target - env_x);
+            const auto peaked    = attacking && next > 1.0f;
+            const auto emptied   = !idle && !attacking && next < 0.0f;
+            env_x    = peaked ? Splat<V>(1.0f) : (emptied ? Splat<V>(0.0f) : (idle ? env_x : next));
+            env_mode = peaked ? Splat<V>(kEnvDecay) : (emptied ? Splat<V>(kEnvIdle) : env_mode);
+            const V amp = idle ? Splat<V>(0.0f) : env_x;
+
+            StoreLanes(low * (amp * volume), out, lane, i);
+        }
+    }
+
+    Store(lfo_phase_ + lane, lfo_phase);
+    Store(svf_low_ + lane, svf_low);
+    Store(svf_band_ + lane, svf_band);
+    Store(svf_freq_ + lane, freq);
+    Store(svf_damp_ + lane, damp);
+    Store(svf_freq_step_ + lane, freq_step);
+    Store(svf_damp_step_ + lane, damp_step);
+    Store(env_x_ + lane, env_x);
+    Store(env_mode_ + lane, env_mode);
+#if DRONE_BANK_AVX
+    Store(osc_phase_, osc_phase);
+#else
+    Store(osc_phase_ + lane, osc1_phase);
+    Store(osc_phase_ + kLanes + lane, osc2_phase);
+#endif
+    return left;
+}
+
+template <typename V>
+uint32_t DroneBank::SkipLanes(int lane, size_t size) {
+    V       lfo_phase = Load<V>(lfo_phase_ + lane);
+    const V lfo_inc   = Load<V>(lfo_inc_ + lane) * static_cast<float>(control_period_);
+
+    // Same control-period walk as ProcessLanes, without the audio.
+    uint32_t left = control_left_;
+    size_t   i    = 0;
+    while(i < size) {
+        if(left == 0) {
+            Triangle(lfo_phase, lfo_inc);
+            left = control_period_;
+        }
+        const size_t n = size - i < left ? size - i : left;
+        i += n;
+        left -= static_cast<uint32_t>(n);
+    }
+
+    Store(lfo_phase_ + lane, lfo_phase);
+    return left;
+}
+
+bool DroneBank::Idle(int voice) const {
+    return !gate_[voice] && env_mode_[voice] == kEnvIdle;
+}
+
+void DroneBank::WakeLane(int lane) {
+    osc_phase_[lane]          = 0.0f;
+    osc_phase_[lane + kLanes] = 0.0f;
+    svf_low_[lane]            = 0.0f;
+    svf_band_[lane]           = 0.0f;
+
+    // Coefficients for the LFO's current position, without advancing it.
+    float lfo_phase = lfo_phase_[lane];
+    const float lfo_val = Triangle<float>(lfo_phase, 0.0f);
+    SvfCoefficients<float>(ModulatedCutoff<float>(lfo_val, base_cutoff_[lane], lfo_depth_[lane]),
+                           svf_res_damp_[lane], sample_rate_, svf_freq_[lane], svf_damp_[lane]);
+    svf_freq_step_[lane] = 0.0f;
+    svf_damp_step_[lane] = 0.0f;
+}
+
+void DroneBank::Process(float* const out[kVoices], size_t size) {
+    bool all_idle = true;
+    for(int l = 0; l < kVoices; l++) {
+        if(gate_[l] && !prev_gate_[l]) {
+            if(env_mode_[l] == kEnvIdle) {
+                WakeLane(l);
+            }
+            env_mode_[l] = kEnvAttack;
+        } else if(!gate_[l] && prev_gate_[l]) {
+            env_mode_[l] = kEnvRelease;
+        }
+        prev_gate_[l] = gate_[l];
+        all_idle      = all_idle && Idle(l);
+    }
+
+    if(all_idle) {
+        for(int l = 0; l < kVoices; l++) {
+            memset(out[l], 0, size * sizeof(float));
+        }
+#if DRONE_BANK_VECTOR
+        control_left_ = SkipLanes<F4>(0, size);
+#else
+        uint32_t left = control_left_;
+        for(int l = 0; l < kVoices; l++) {
+            left = SkipLanes<float>(l, size);
+        }
+        control_left_ = left;
+#endif
+        return;
+    }
+
+#if DRONE_BANK_VECTOR
+    control_left_ = ProcessLanes<F4>(0, out, size);
+#else
+    // Every lane starts from the same point in the control period. Idle lanes
+    // only need their LFO moved on.
+    uint32_t left = control_left_;
+    for(int l = 0; l < kVoices; l++) {
+        if(Idle(l)) {
+            memset(out[l], 0, size * sizeof(float));
+            left = SkipLanes<float>(l, size);
+        } else {
+            left = ProcessLanes<float>(l, out, size);
+        }
+    }
+    control_left_ = left;
+#endif
+}
+
+} // namespace ambient
@@ -0,0 +1,130 @@
+// drone_bank.h
+// Drone Bank — Structure-of-Arrays Drone Voices
+// The sustained drones (two detuned polyBLEP saws -> SVF lowpass -> ADSR, with a
+// slow triangle LFO on the cutoff) stored as contiguous lane arrays so every drone
+// advances in the same instruction stream. The cutoff LFO runs at control rate:
+// SVF coefficients are recomputed every control period and glide linearly between.
+// Host: one vector lane per drone (SSE, or AVX for the oscillator pairs).
+// Cortex-M7: the same kernel run once per lane on plain floats.
+// Math follows daisysp::Oscillator / Svf / Adsr; see Process() for the tolerance.
+// With `make OSC=wavetable` (AMBIENT_OSC_WAVETABLE) the saws read the shared
+// band-limited tables in wavetable.h instead of being computed with polyBLEP.
+
+#ifndef DRONE_BANK_H
+#define DRONE_BANK_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+struct DroneParams {
+    float attack;
+    float decay;
+    float sustain;
+    float release;
+    float filter_freq;
+    float filter_res;
+    float detune_cents;
+    float volume;
+    float lfo_rate;
+    float lfo_depth;
+};
+
+class DroneBank {
+  public:
+    static const int kVoices = 3;
+    static const int kLanes  = 4; // kVoices padded to one SSE register
+
+    DroneBank() {}
+    ~DroneBank() {}
+
+    void Init(float sample_rate, const DroneParams params[kVoices]);
+
+    // Oscillator pitch; osc2 follows at the voice's detune ratio.
+    void  SetFreq(int voice, float freq);
+    float Freq(int voice) const { return freq_[voice]; }
+
+    void SetGate(int voice, bool gate) { gate_[voice] = gate; }
+    bool Gate(int voice) const { return gate_[voice]; }
+
+    // Gate off and envelope finished: the voice outputs exact zeros. Process skips
+    // the audio kernel while every voice is idle (only the cutoff LFO keeps moving),
+    // and a voice woken from idle restarts from reset oscillator and filter state,
+    // so its output never depends on how long or in what blocks it slept.
+    bool Idle(int voice) const;
+
+    // Samples between cutoff updates (>= 1). With a period of 1 the bank matches
+    // the per-voice DaisySP chain to within float rounding (|diff| < 1e-5);
+    // reciprocals replace the per-sample divides, a polynomial replaces sinf
+    // in the SVF coefficient and the coefficient glide adds one rounding.
+    void     SetControlPeriod(uint32_t samples);
+    uint32_t ControlPeriod() const { return control_period_; }
+
+    // Renders `size` samples per voice into out[0..kVoices-1].
+    void Process(float* const out[kVoices], size_t size);
+
+  private:
+    // Both return the samples left in the current control period.
+    template <typename V>
+    uint32_t ProcessLanes(int lane, float* const out[kVoices], size_t size);
+    template <typename V>
+    uint32_t SkipLanes(int lane, size_t size);
+
+    void WakeLane(int lane);
+
+    float sample_rate_;
+    float sr_recip_;
+    float freq_[kLanes];
+    float detune_ratio_[kLanes];
+    bool  gate_[kLanes];
+    bool  prev_gate_[kLanes];
+
+    uint32_t control_period_;
+    uint32_t control_left_;
+
+    // Oscillators: lanes 0-3 are osc1, lanes 4-7 the detuned osc2.
+    alignas(32) float osc_phase_[kLanes * 2];
+    alignas(32) float osc_inc_[kLanes * 2];
+    alignas(32) float osc_inv_inc_[kLanes * 2];
+#if defined(AMBIENT_OSC_WAVETABLE)
+    const float* osc_table_[kLanes * 2]; // saw level for each oscillator's pitch
+    alignas(32) float osc_length_[kLanes * 2];
+#endif
+
+    // Cutoff LFO (triangle) and its mapping onto the SVF.
+    alignas(16) float lfo_phase_[kLanes];
+    alignas(16) float lfo_inc_[kLanes];
+    alignas(16) float base_cutoff_[kLanes];
+    alignas(16) float lfo_depth_[kLanes];
+
+    // SVF state and resonance-derived constants.
+    alignas(16) float svf_low_[kLanes];
+    alignas(16) float svf_band_[kLanes];
+    alignas(16) float svf_res_damp_[kLanes];
+    alignas(16) float svf_drive_[kLanes];
+
+    // SVF coefficients in use and their per-sample glide toward the next update.
+    alignas(16) float svf_freq_[kLanes];
+    alignas(16) float svf_damp_[kLanes];
+    alignas(16) float svf_freq_step_[kLanes];
+    alignas(16) float svf_damp_step_[kLanes];
+
+    // ADSR state; env_mode_ holds the daisysp ADSR_SEG_* value as a float.
+    alignas(16) float env_x_[kLanes];
+    alignas(16) float env_mode_[kLanes];
+    alignas(16) float env_attack_d0_[kLanes];
+    alignas(16) float env_attack_target_[kLanes];
+    alignas(16) float env_decay_d0_[kLanes];
+    alignas(16) float env_release_d0_[kLanes];
+    alignas(16) float env_sustain_[kLanes];
+
+    alignas(16) float volume_[kLanes];
+};
+
+// The engine's drone voices (V1, V3, V5), for Engine::Init and the host benches.
+extern const DroneParams kDroneParams[DroneBank::kVoices];
+
+} // namespace ambient
+
+#endif // DRONE_BANK_H
@@ -0,0 +1,95 @@
+// event_queue.h
+// Event Queue — Sample-Timestamped Control Events for the Block Renderer
+// Each cycle's follower triggers, pad release and next cycle tick are scheduled
+// once, as absolute sample times, when the cycle starts. The engine renders
+// branch-free up to the earliest pending event and dispatches it there.
+// Fixed capacity, no allocation; header-only.
+
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+enum EventType : uint8_t {
+    EVENT_CYCLE_TICK,
+    EVENT_FOLLOWER_TRIGGER,
+    EVENT_PAD_RELEASE,
+};
+
+struct Event {
+    uint64_t  time;        // absolute sample index (Engine sample clock)
+    float     cycle_point; // position in the cycle 0..1, or < 0 for fixed-time events
+    EventType type;
+    uint8_t   index; // follower 0-2 for EVENT_FOLLOWER_TRIGGER
+};
+
+// Pending events kept sorted by time; events with equal times stay in push order.
+class EventQueue {
+  public:
+    static const size_t kCapacity = 8;
+
+    void Clear() { size_ = 0; }
+
+    bool   Empty() const { return size_ == 0; }
+    size_t Size() const { return size_; }
+
+    const Event& Front() const { return events_[0]; }
+
+    // Returns false when the queue is full.
+    bool Push(const Event& ev) {
+        if(size_ == kCapacity) {
+            return false;
+        }
+        size_t i = size_++;
+        while(i > 0 && events_[i - 1].time > ev.time) {
+            events_[i] = events_[i - 1];
+            i--;
+        }
+        events_[i] = ev;
+        return true;
+    }
+
+    void Pop() {
+        for(size_t i = 1; i < size_; i++) {
+            events_[i - 1] = events_[i];
+        }
+        size_--;
+    }
+
+    // Drops every pending event of the given type.
+    void Remove(EventType type) {
+        size_t kept = 0;
+        for(size_t i = 0; i < size_; i++) {
+            if(events_[i].type != type) {
+                events_[kept++] = events_[i];
+            }
+        }
+        size_ = kept;
+    }
+
+    // Direct access for retiming; call Sort() afterwards.
+    Event& At(size_t i) { return events_[i]; }
+
+    void Sort() {
+        for(size_t i = 1; i < size_; i++) {
+            const Event ev = events_[i];
+            size_t      j  = i;
+            while(j > 0 && events_[j - 1].time > ev.time) {
+                events_[j] = events_[j - 1];
+                j--;
+            }
+            events_[j] = ev;
+        }
+    }
+
+  private:
+    Event  events_[kCapacity];
+    size_t size_ = 0;
+};
+
+} // namespace ambient
+
+#endif // EVENT_QUEUE_H
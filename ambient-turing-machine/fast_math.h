@@ -0,0 +1,94 @@
+// fast_math.h
+// Fast Math — Pitch and Gain Kernels Without libm Transcendentals
+// exp2 by range reduction + polynomial, cents/semitone ratios built on it,
+// and a table-driven MIDI-to-frequency for integer notes.
+// Header-only, no dependencies; shared by the engine and turing_sequencer.h.
+//
+// Maximum error (checked by host/build/fast_math_check):
+//   exp2f_fast(x), |x| < 126          relative 3e-7 (about 0.0005 cent)
+//   cents_to_ratio, |cents| <= 2400    relative 4e-7 (argument scaling adds one rounding)
+//   midi_to_freq(float), 0..127        relative 6e-7 (about 0.001 cent)
+//   midi_to_freq(int), -1200..1499     relative 1e-7 (two float roundings)
+//   midi_to_freq(int), 1500 and up     +inf, as 440 * powf(2, (n - 69) / 12)
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace fastmath {
+
+// =============================================
+// EXP2
+// =============================================
+
+// 2^x for |x| < 126. Splits x into integer and fractional parts, evaluates a
+// degree-5 Chebyshev fit of 2^f on [0, 1) and builds 2^i in the exponent bits.
+inline float exp2f_fast(float x) {
+    // floor() without libm or branches: truncate, then step down for negative fractions.
+    int32_t i = static_cast<int32_t>(x);
+    i -= static_cast<int32_t>(static_cast<float>(i) > x);
+    const float f = x - static_cast<float>(i);
+
+    float p = 0.0018951073288917542f;
+    p       = p * f + 0.00894621480256319f;
+    p       = p * f + 0.055863283574581146f;
+    p       = p * f + 0.24014076590538025f;
+    p       = p * f + 0.6931546330451965f;
+    p       = p * f + 1.0f;
+
+    const uint32_t bits = static_cast<uint32_t>(i + 127) << 23;
+    float          scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// =============================================
+// PITCH RATIOS
+// =============================================
+
+inline float cents_to_ratio(float cents) {
+    return exp2f_fast(cents * (1.0f / 1200.0f));
+}
+
+inline float semitones_to_ratio(float semitones) {
+    return exp2f_fast(semitones * (1.0f / 12.0f));
+}
+
+// Continuous MIDI note (A4 = 69 = 440 Hz).
+inline float midi_to_freq(float midi_note) {
+    return 440.0f * exp2f_fast((midi_note - 69.0f) * (1.0f / 12.0f));
+}
+
+// 2^(k/12) for k = 0..11, times C-1 (MIDI 0) = 8.1757989156 Hz. Shared with the
+// compile-time note tables in sequencer_rules.h.
+constexpr float kMidiOctaveZero[12] = {
+    8.17579891564f,  8.66195721803f,  9.17702399742f,  9.72271824132f,
+    10.3008611535f,  10.9133822323f,  11.5623257097f,  12.2498573744f,
+    12.9782717994f,  13.75f,          14.5676175474f,  15.4338531643f,
+};
+
+// Integer MIDI note: exact 12-TET ratio table plus an octave shift in the
+// exponent, so sequencer notes cost one table load and one multiply. The octave
+// saturates before it leaves the exponent field: far above MIDI 127 (the
+// Wanderer and Echo get there in long runs) the result overflows to +inf like
+// powf, never wrapping into the sign bit; far below it stays positive.
+inline float midi_to_freq(int midi_note) {
+    int octave = midi_note / 12;
+    int note   = midi_note % 12;
+    if(note < 0) {
+        note += 12;
+        octave--;
+    }
+    octave = octave > 128 ? 128 : (octave < -126 ? -126 : octave);
+
+    const uint32_t bits = static_cast<uint32_t>(octave + 127) << 23;
+    float          scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return kMidiOctaveZero[note] * scale;
+}
+
+} // namespace fastmath
+
+#endif // FAST_MATH_H
@@ -0,0 +1,174 @@
+#include "fdn_reverb.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace ambient {
+
+// daisysp::ReverbSc base delay lengths at 48 kHz (without its pitch modulation),
+// in the same line order: even lines take and feed the left channel, odd the right.
+static const uint32_t kBaseLengths[FdnReverb::kLines] = {2473, 2767, 3217, 3557, 3907, 4127, 2143, 1933};
+
+static const float kOutputGain    = 0.35f; // as ReverbSc
+static const float kHadamardScale = 0.35355339059327376f; // 1/sqrt(8): orthogonal mix
+
+// =============================================
+// LANE TYPES
+// =============================================
+// Lines 0-3 and 4-7 in one vector each (GCC/Clang vector extensions: SSE on x86,
+// NEON on aarch64). The Cortex-M7 has no float SIMD and runs the scalar loop.
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define FDN_REVERB_VECTOR 1
+typedef float   F4 __attribute__((vector_size(16)));
+typedef int32_t I4 __attribute__((vector_size(16)));
+#if defined(__clang__)
+#define FDN_SHUFFLE(v, a, b, c, d) __builtin_shufflevector(v, v, a, b, c, d)
+#else
+#define FDN_SHUFFLE(v, a, b, c, d) __builtin_shuffle(v, I4{a, b, c, d})
+#endif
+
+static inline F4 LoadF4(const float* p) {
+    F4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void StoreF4(float* p, F4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// Hadamard butterflies at distances 2 and 1 inside one register.
+static inline F4 Butterfly4(F4 x) {
+    const F4 sign2 = {1.0f, 1.0f, -1.0f, -1.0f};
+    const F4 sign1 = {1.0f, -1.0f, 1.0f, -1.0f};
+    x = FDN_SHUFFLE(x, 0, 1, 0, 1) + FDN_SHUFFLE(x, 2, 3, 2, 3) * sign2;
+    return FDN_SHUFFLE(x, 0, 0, 2, 2) + FDN_SHUFFLE(x, 1, 1, 3, 3) * sign1;
+}
+#endif
+
+void FdnReverb::Init(float sample_rate) {
+    sample_rate_ = sample_rate;
+    feedback_    = 0.97f;
+
+    const float rate  = sample_rate < static_cast<float>(kMaxSampleRate) ? sample_rate : static_cast<float>(kMaxSampleRate);
+    float*      start = buffer_;
+    for(int l = 0; l < kLines; l++) {
+        length_[l] = static_cast<uint32_t>(static_cast<float>(kBaseLengths[l]) * rate / 48000.0f + 0.5f);
+        if(length_[l] < kMaxBlock) {
+            length_[l] = kMaxBlock;
+        }
+        pos_[l]   = 0;
+        line_[l]  = start;
+        state_[l] = 0.0f;
+        start += length_[l];
+    }
+    memset(buffer_, 0, sizeof(buffer_));
+    SetLpFreq(10000.0f);
+}
+
+// One-pole lowpass coefficient exactly as ReverbSc computes it.
+void FdnReverb::SetLpFreq(float freq) {
+    double damp_fact = 2.0 - cos(static_cast<double>(freq) * (2.0 * M_PI) / static_cast<double>(sample_rate_));
+    damp_fact        = damp_fact - sqrt(damp_fact * damp_fact - 1.0);
+    damp_            = static_cast<float>(damp_fact);
+}
+
+void FdnReverb::Process(const float* in_l, const float* in_r, float* out_l, float* out_r, size_t size) {
+    // Gather: taps_[i][l] is the sample line l delivers at step i of the block.
+    for(int l = 0; l < kLines; l++) {
+        const float*   line  = line_[l];
+        const uint32_t pos   = pos_[l];
+        const uint32_t left  = length_[l] - pos;
+        const size_t   first = left < size ? left : size;
+        for(size_t i = 0; i < first; i++) {
+            taps_[i][l] = line[pos + i];
+        }
+        for(size_t i = first; i < size; i++) {
+            taps_[i][l] = line[i - first];
+        }
+    }
+
+    // Damp, tap the outputs, mix, add the input; the result replaces the taps.
+#if defined(FDN_REVERB_VECTOR)
+    F4       s_lo = LoadF4(&state_[0]);
+    F4       s_hi = LoadF4(&state_[4]);
+    const F4 fb   = F4{} + feedback_;
+    const F4 damp = F4{} + damp_;
+    for(size_t i = 0; i < size; i++) {
+        const F4 v_lo = LoadF4(&taps_[i][0]) * fb;
+        const F4 v_hi = LoadF4(&taps_[i][4]) * fb;
+        s_lo          = (s_lo - v_lo) * damp + v_lo;
+        s_hi          = (s_hi - v_hi) * damp + v_hi;
+
+        const F4 sum  = s_lo + s_hi;
+        const float l = (sum[0] + sum[2]) * kOutputGain;
+        const float r = (sum[1] + sum[3]) * kOutputGain;
+
+        const F4 in = {in_l[i], in_r[i], in_l[i], in_r[i]};
+        StoreF4(&taps_[i][0], Butterfly4(s_lo + s_hi) * kHadamardScale + in);
+        StoreF4(&taps_[i][4], Butterfly4(s_lo - s_hi) * kHadamardScale + in);
+
+        out_l[i] = l;
+        out_r[i] = r;
+    }
+    StoreF4(&state_[0], s_lo);
+    StoreF4(&state_[4], s_hi);
+#else
+    for(size_t i = 0; i < size; i++) {
+        float* const tap = taps_[i];
+        float        h[kLines];
+        for(int l = 0; l < kLines; l++) {
+            const float v = tap[l] * feedback_;
+            state_[l]     = (state_[l] - v) * damp_ + v;
+            h[l]          = state_[l];
+        }
+        const float l_out = (h[0] + h[2] + h[4] + h[6]) * kOutputGain;
+        const float r_out = (h[1] + h[3] + h[5] + h[7]) * kOutputGain;
+
+        // Same butterfly order as the vector path, so both produce the same mix.
+        for(int l = 0; l < 4; l++) {
+            const float a = h[l];
+            const float b = h[l + 4];
+            h[l]          = a + b;
+            h[l + 4]      = a - b;
+        }
+        for(int base = 0; base < kLines; base += 4) {
+            float* const x = h + base;
+            const float  a0 = x[0] + x[2], a1 = x[1] + x[3], a2 = x[0] - x[2], a3 = x[1] - x[3];
+            x[0] = a0 + a1;
+            x[1] = a0 - a1;
+            x[2] = a2 + a3;
+            x[3] = a2 - a3;
+        }
+
+        const float in = in_l[i];
+        const float ir = in_r[i];
+        for(int l = 0; l < kLines; l += 2) {
+            tap[l]     = h[l] * kHadamardScale + in;
+            tap[l + 1] = h[l + 1] * kHadamardScale + ir;
+        }
+
+        out_l[i] = l_out;
+        out_r[i] = r_out;
+    }
+#endif
+
+    // Scatter the block back over the samples just read.
+    for(int l = 0; l < kLines; l++) {
+        float* const   line  = line_[l];
+        const uint32_t pos   = pos_[l];
+        const uint32_t left  = length_[l] - pos;
+        const size_t   first = left < size ? left : size;
+        for(size_t i = 0; i < first; i++) {
+            line[pos + i] = taps_[i][l];
+        }
+        for(size_t i = first; i < size; i++) {
+            line[i - first] = taps_[i][l];
+        }
+        const uint32_t next = pos + static_cast<uint32_t>(size);
+        pos_[l]             = next >= length_[l] ? next - length_[l] : next;
+    }
+}
+
+} // namespace ambient
@@ -0,0 +1,60 @@
+// fdn_reverb.h
+// FDN Reverb — 8-Line Feedback Delay Network With a Hadamard Mix
+// A cheaper stand-in for daisysp::ReverbSc with the same controls. It uses the same
+// eight delay lengths, the same per-pass feedback gain and the same one-pole
+// damping in the loop, so SetFeedback/SetLpFreq give the same decay time and
+// tone. Differences: taps are whole samples (no modulated cubic interpolation),
+// and the lines are mixed by a scaled 8x8 Hadamard matrix instead of ReverbSc's
+// Householder-style "jp" term. Both matrices are orthogonal, so the loop gain is
+// exactly the feedback.
+// Every line is longer than kMaxBlock, so nothing written in a block is read in
+// the same block: Process copies each line's taps for the whole block, mixes
+// them sample by sample (host: two SSE/NEON registers of four lines; Cortex-M7:
+// plain float loops), and writes the block back.
+// Build the engine with it via `make REVERB=fdn` (AMBIENT_REVERB_FDN).
+
+#ifndef FDN_REVERB_H
+#define FDN_REVERB_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+class FdnReverb {
+  public:
+    static const int    kLines         = 8;
+    static const size_t kMaxBlock      = 128;   // longest Process call
+    static const int    kMaxSampleRate = 96000; // delay memory is sized for this rate
+
+    FdnReverb() {}
+    ~FdnReverb() {}
+
+    void Init(float sample_rate);
+
+    // Same meaning and defaults as daisysp::ReverbSc: per-pass gain of each line
+    // (0..1, ~0.9 is a long tail) and the in-loop lowpass cutoff in Hz.
+    void SetFeedback(float feedback) { feedback_ = feedback; }
+    void SetLpFreq(float freq);
+
+    // Stereo in, stereo out; size <= kMaxBlock. In-place (out == in) is fine.
+    void Process(const float* in_l, const float* in_r, float* out_l, float* out_r, size_t size);
+
+  private:
+    // Delay memory for all lines at kMaxSampleRate (sum of the ReverbSc base lengths).
+    static const uint32_t kBufferSize = 48248;
+
+    float    sample_rate_;
+    float    feedback_;
+    float    damp_;
+    uint32_t length_[kLines];
+    uint32_t pos_[kLines];   // oldest sample of each line, overwritten by the block's output
+    float*   line_[kLines];  // start of each line inside buffer_
+    float    state_[kLines]; // damping filter outputs
+    float    taps_[kMaxBlock][kLines];
+    float    buffer_[kBufferSize];
+};
+
+} // namespace ambient
+
+#endif // FDN_REVERB_H
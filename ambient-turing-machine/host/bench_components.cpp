@@ -0,0 +1,398 @@
+// bench_components.cpp
+// Cost of each DSP component and of the full engine, in ns per output sample and
+// as a share of the real-time budget, at block sizes 1/8/48/256 and 48/96 kHz.
+//
+// Components run on their own with the engine's parameters:
+//   drone_voice  one pre-bank DroneVoice (drone_voice_ref.h), gate held
+//   drone_bank   the three-voice DroneBank, gates held
+//   sparkle      one SparkleVoice (StringVoice), plucked every 250 ms
+//   pad          PadVoice, gate held
+//   osc_blep_saw / osc_tri  one daisysp::Oscillator (WAVE_POLYBLEP_SAW at 110 Hz,
+//                WAVE_TRI at 220 Hz), the drone and pad waveforms
+//   osc_table_saw / osc_table_tri  the same as WavetableOscillator (wavetable.h)
+//   sampler      SamplePlayer over the converted sample (as linked, ADPCM by default)
+//   sampler_pcm16  the same player over the decoded sample stored as raw PCM16
+//   sampler_linear / sampler_hermite  the player a fourth down, with each interpolator
+//   decode_adpcm / decode_pcm16  SampleStream::FillTo alone, per decoded sample
+//   delay_pair   the two DelayLine<float> the engine used before stereo_delay.h
+//   delay_float / delay_int16 / delay_bf16  StereoDelay in each storage format,
+//                one Read and one Write per block
+//   reverb       ReverbSc, stereo in/out
+//   reverb_fdn   FdnReverb (fdn_reverb.h) at the same settings, one call per block
+//   graph        Engine::Process (everything, with sequencing)
+// Every point is the fastest of `repeats` runs, under the same denormal flushing as
+// Engine::Process. Output is CSV on stdout so runs can be diffed across commits:
+//
+//   component,sample_rate,block,ns_per_sample,budget_pct
+//
+//   bench_components [seconds] [repeats] [component]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ambient_engine.h"
+#include "denormals.h"
+#include "drone_bank.h"
+#include "drone_voice_ref.h"
+#include "fdn_reverb.h"
+#include "sample_data.h"
+#include "sample_stream.h"
+#include "stereo_delay.h"
+#include "wavetable.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const float  kSampleRates[] = {48000.0f, 96000.0f};
+static const size_t kBlocks[]      = {1, 8, 48, 256};
+static const size_t kMaxBlock      = 256;
+
+// Matches Engine::Init; delay and reverb inputs are a fixed noise signal at about -20 dBFS.
+static const float kDelayFeedback  = 0.25f;
+static const float kDelayTimeSec   = 0.85f;
+static const float kReverbFeedback = 0.90f;
+static const float kReverbLpFreq   = 6500.0f;
+
+// The DelayLine pair the engine used before stereo_delay.h, for comparison.
+typedef daisysp::DelayLine<float, 96000> MonoDelayLine;
+
+static ambient::DelayBuffer delay;
+static MonoDelayLine        pair_l;
+static MonoDelayLine        pair_r;
+static ambient::Engine      engine;
+static ambient::DroneBank   bank;
+static DroneVoice           drone;
+static ambient::SparkleVoice sparkle;
+static ambient::PadVoice    pad;
+static ambient::SamplePlayer sampler;
+static daisysp::ReverbSc    reverb;
+static ambient::FdnReverb   reverb_fdn;
+static ambient::SampleStream stream;
+static daisysp::Oscillator  osc;
+static ambient::WavetableOscillator osc_table;
+
+// The linked sample, as ADPCM and as raw PCM16 (decoded once at startup).
+static uint8_t* adpcm_bytes = nullptr;
+static uint8_t* pcm16_bytes = nullptr;
+
+static float  input[kMaxBlock];
+static float  out_buf[4][kMaxBlock * 2];
+static double checksum = 0.0;
+
+// One component: Init prepares a fresh instance, Render produces `size` samples.
+struct Component {
+    const char* name;
+    void (*init)(float sample_rate);
+    void (*render)(size_t size, uint64_t clock, float sample_rate);
+};
+
+static void SetupDroneVoice(float sr) {
+    InitDroneVoice(drone, ambient::kDroneParams[0], sr);
+    drone.env_gate     = true;
+    drone.current_freq = 130.81f;
+}
+static void RunDroneVoice(size_t size, uint64_t, float) {
+    RenderDroneVoice(drone, out_buf[0], size);
+}
+
+static void SetupDroneBank(float sr) {
+    bank.Init(sr, ambient::kDroneParams);
+    for(int v = 0; v < 3; v++) {
+        bank.SetFreq(v, 110.0f * static_cast<float>(v + 1));
+        bank.SetGate(v, true);
+    }
+}
+static void RunDroneBank(size_t size, uint64_t, float) {
+    float* const out[3] = {out_buf[0], out_buf[1], out_buf[2]};
+    bank.Process(out, size);
+}
+
+static void SetupSparkle(float sr) {
+    sparkle.Init(sr, 0);
+}
+static void RunSparkle(size_t size, uint64_t clock, float sr) {
+    // Pluck when this block crosses a 250 ms boundary, as the engine would at a run start.
+    const uint64_t period = static_cast<uint64_t>(0.25f * sr);
+    if(clock % period < size || size >= period) {
+        if(sparkle.asleep) {
+            sparkle.string.Reset();
+            sparkle.asleep = false;
+        }
+        sparkle.quiet_samples = 0;
+        sparkle.string.SetFreq(523.25f);
+        sparkle.string.Trig();
+    }
+    sparkle.Render(out_buf[0], size);
+}
+
+static void SetupPad(float sr) {
+    pad.Init(sr);
+    pad.env_gate     = true;
+    pad.current_freq = 220.0f;
+}
+static void RunPad(size_t size, uint64_t, float) {
+    pad.Render(out_buf[0], size, ambient::kDefaultControlPeriod);
+}
+
+static void SetupOscBlepSaw(float sr) {
+    osc.Init(sr);
+    osc.SetWaveform(daisysp::Oscillator::WAVE_POLYBLEP_SAW);
+    osc.SetAmp(1.0f);
+    osc.SetFreq(110.0f);
+}
+static void SetupOscTri(float sr) {
+    osc.Init(sr);
+    osc.SetWaveform(daisysp::Oscillator::WAVE_TRI);
+    osc.SetAmp(1.0f);
+    osc.SetFreq(220.0f);
+}
+static void RunOsc(size_t size, uint64_t, float) {
+    for(size_t i = 0; i < size; i++) {
+        out_buf[0][i] = osc.Process();
+    }
+}
+
+static void SetupOscTableSaw(float sr) {
+    osc_table.Init(sr);
+    osc_table.SetWaveform(daisysp::Oscillator::WAVE_POLYBLEP_SAW);
+    osc_table.SetAmp(1.0f);
+    osc_table.SetFreq(110.0f);
+}
+static void SetupOscTableTri(float sr) {
+    osc_table.Init(sr);
+    osc_table.SetWaveform(daisysp::Oscillator::WAVE_TRI);
+    osc_table.SetAmp(1.0f);
+    osc_table.SetFreq(220.0f);
+}
+static void RunOscTable(size_t size, uint64_t, float) {
+    for(size_t i = 0; i < size; i++) {
+        out_buf[0][i] = osc_table.Process();
+    }
+}
+
+static void SetupSampler(float sr) {
+    sampler.Init(sr);
+}
+static void RunSampler(size_t size, uint64_t, float) {
+    sampler.Render(out_buf[0], size, ambient::kDefaultControlPeriod);
+}
+
+static void SetupSamplerPcm16(float sr) {
+    sampler.Init(sr);
+    sampler.stream.Init(pcm16_bytes, sample_data.length, ambient::SAMPLE_CODEC_PCM16, sample_data.loop_start, sample_data.loop_end);
+}
+
+// Non-unity rate, so the interpolator runs on every sample.
+static const float kBenchPlaybackRate = 0.7491535f; // 2^(-5/12)
+
+static void SetupSamplerLinear(float sr) {
+    sampler.Init(sr);
+    sampler.SetPlaybackRate(kBenchPlaybackRate);
+    sampler.interp = ambient::SAMPLE_INTERP_LINEAR;
+}
+static void SetupSamplerHermite(float sr) {
+    sampler.Init(sr);
+    sampler.SetPlaybackRate(kBenchPlaybackRate);
+    sampler.interp = ambient::SAMPLE_INTERP_HERMITE;
+}
+
+static void SetupDecodeAdpcm(float) {
+    stream.Init(adpcm_bytes, sample_data.length, ambient::SAMPLE_CODEC_IMA_ADPCM, sample_data.loop_start, sample_data.loop_end);
+}
+static void SetupDecodePcm16(float) {
+    stream.Init(pcm16_bytes, sample_data.length, ambient::SAMPLE_CODEC_PCM16, sample_data.loop_start, sample_data.loop_end);
+}
+static void RunDecode(size_t size, uint64_t clock, float) {
+    stream.FillTo(static_cast<uint32_t>(clock + size));
+    out_buf[0][0] = stream.At(static_cast<uint32_t>(clock));
+}
+
+static void SetupDelayPair(float sr) {
+    pair_l.Init();
+    pair_r.Init();
+    pair_l.SetDelay(kDelayTimeSec * sr);
+    pair_r.SetDelay((kDelayTimeSec + 0.018f) * sr);
+}
+static void RunDelayPair(size_t size, uint64_t, float) {
+    for(size_t i = 0; i < size; i++) {
+        const float read_l = pair_l.Read();
+        const float read_r = pair_r.Read();
+        pair_l.Write(input[i] + read_l * kDelayFeedback);
+        pair_r.Write(input[i] + read_r * kDelayFeedback);
+        out_buf[0][i] = read_l;
+        out_buf[1][i] = read_r;
+    }
+}
+
+// One StereoDelay per storage format.
+template <typename Format>
+static ambient::StereoDelay<Format, 96000>& StereoDelayFor() {
+    static ambient::StereoDelay<Format, 96000> d;
+    return d;
+}
+
+template <typename Format>
+static void SetupStereoDelay(float sr) {
+    ambient::StereoDelay<Format, 96000>& d = StereoDelayFor<Format>();
+    d.Init();
+    d.SetRightOffset(static_cast<uint32_t>(0.018f * sr + 0.5f));
+    d.SetDelay(kDelayTimeSec * sr);
+}
+template <typename Format>
+static void RunStereoDelay(size_t size, uint64_t, float) {
+    ambient::StereoDelay<Format, 96000>& d = StereoDelayFor<Format>();
+    d.Read(out_buf[0], out_buf[1], size);
+    for(size_t i = 0; i < size; i++) {
+        out_buf[2][i] = input[i] + out_buf[0][i] * kDelayFeedback;
+        out_buf[3][i] = input[i] + out_buf[1][i] * kDelayFeedback;
+    }
+    d.Write(out_buf[2], out_buf[3], size);
+}
+
+static void SetupReverb(float sr) {
+    reverb.Init(sr);
+    reverb.SetFeedback(kReverbFeedback);
+    reverb.SetLpFreq(kReverbLpFreq);
+}
+static void RunReverb(size_t size, uint64_t, float) {
+    for(size_t i = 0; i < size; i++) {
+        reverb.Process(input[i], input[i], &out_buf[0][i], &out_buf[1][i]);
+    }
+}
+
+static void SetupReverbFdn(float sr) {
+    reverb_fdn.Init(sr);
+    reverb_fdn.SetFeedback(kReverbFeedback);
+    reverb_fdn.SetLpFreq(kReverbLpFreq);
+}
+static void RunReverbFdn(size_t size, uint64_t, float) {
+    // The engine never calls it with more than Engine::kMaxBlockSize frames.
+    for(size_t i = 0; i < size; i += ambient::FdnReverb::kMaxBlock) {
+        const size_t n = size - i < ambient::FdnReverb::kMaxBlock ? size - i : ambient::FdnReverb::kMaxBlock;
+        reverb_fdn.Process(input + i, input + i, &out_buf[0][i], &out_buf[1][i], n);
+    }
+}
+
+static void SetupGraph(float sr) {
+    engine.Init(sr, &delay);
+}
+static void RunGraph(size_t size, uint64_t, float) {
+    engine.Process(out_buf[0], size * 2);
+    engine.PrepareNextCycle();
+}
+
+static const Component kComponents[] = {
+    {"drone_voice", SetupDroneVoice, RunDroneVoice},
+    {"drone_bank", SetupDroneBank, RunDroneBank},
+    {"sparkle", SetupSparkle, RunSparkle},
+    {"pad", SetupPad, RunPad},
+    {"osc_blep_saw", SetupOscBlepSaw, RunOsc},
+    {"osc_tri", SetupOscTri, RunOsc},
+    {"osc_table_saw", SetupOscTableSaw, RunOscTable},
+    {"osc_table_tri", SetupOscTableTri, RunOscTable},
+    {"sampler", SetupSampler, RunSampler},
+    {"sampler_pcm16", SetupSamplerPcm16, RunSampler},
+    {"sampler_linear", SetupSamplerLinear, RunSampler},
+    {"sampler_hermite", SetupSamplerHermite, RunSampler},
+    {"decode_adpcm", SetupDecodeAdpcm, RunDecode},
+    {"decode_pcm16", SetupDecodePcm16, RunDecode},
+    {"delay_pair", SetupDelayPair, RunDelayPair},
+    {"delay_float", SetupStereoDelay<ambient::DelayFloat32>, RunStereoDelay<ambient::DelayFloat32>},
+    {"delay_int16", SetupStereoDelay<ambient::DelayInt16>, RunStereoDelay<ambient::DelayInt16>},
+    {"delay_bf16", SetupStereoDelay<ambient::DelayBf16>, RunStereoDelay<ambient::DelayBf16>},
+    {"reverb", SetupReverb, RunReverb},
+    {"reverb_fdn", SetupReverbFdn, RunReverbFdn},
+    {"graph", SetupGraph, RunGraph},
+};
+
+// Fills adpcm_bytes and pcm16_bytes from whichever format was linked in.
+static void PrepareSampleCopies() {
+    using ambient::kAdpcmBlockBytes;
+    using ambient::kSampleBlockSamples;
+
+    const uint32_t length = sample_data.length;
+    const uint32_t blocks = (length + kSampleBlockSamples - 1) / kSampleBlockSamples;
+    int16_t*       pcm    = new int16_t[blocks * kSampleBlockSamples]();
+
+    if(sample_data.codec == ambient::SAMPLE_CODEC_IMA_ADPCM) {
+        adpcm_bytes = const_cast<uint8_t*>(sample_data.data);
+        for(uint32_t b = 0; b < blocks; b++) {
+            const uint32_t left = length - b * kSampleBlockSamples;
+            ambient::AdpcmDecodeBlock(sample_data.data + b * kAdpcmBlockBytes, 0,
+                                      left < kSampleBlockSamples ? left : kSampleBlockSamples,
+                                      pcm, b * kSampleBlockSamples, 0xFFFFFFFFu);
+        }
+    } else {
+        // Blob built with SAMPLE_FORMAT=pcm16: there is no ADPCM copy, decode_adpcm is skipped.
+        memcpy(pcm, sample_data.data, length * 2u);
+        adpcm_bytes = nullptr;
+    }
+    pcm16_bytes = reinterpret_cast<uint8_t*>(pcm);
+}
+
+// Wall time per output sample, in ns, rendering `seconds` of audio in `block`-sized calls.
+static double TimeRun(const Component& c, float sample_rate, size_t block, float seconds) {
+    const ambient::ScopedFlushDenormals flush_denormals;
+
+    c.init(sample_rate);
+    const uint64_t total = static_cast<uint64_t>(seconds * sample_rate);
+
+    uint64_t   clock = 0;
+    const auto start = Clock::now();
+    for(; clock < total; clock += block) {
+        c.render(block, clock, sample_rate);
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    checksum += out_buf[0][0] + out_buf[0][block - 1];
+    return elapsed * 1e9 / static_cast<double>(clock);
+}
+
+int main(int argc, char** argv) {
+    const float       seconds = argc > 1 ? static_cast<float>(atof(argv[1])) : 2.0f;
+    const int         repeats = argc > 2 ? atoi(argv[2]) : 3;
+    const char* const only    = argc > 3 ? argv[3] : nullptr;
+
+    if(seconds <= 0.0f || repeats <= 0) {
+        fprintf(stderr, "usage: bench_components [seconds] [repeats] [component]\n");
+        return 1;
+    }
+
+    uint32_t seed = 1u;
+    for(size_t i = 0; i < kMaxBlock; i++) {
+        seed     = seed * 1664525u + 1013904223u;
+        input[i] = (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.2f;
+    }
+
+    if(!MapSampleData(AMBIENT_SAMPLE_BLOB)) {
+        fprintf(stderr, "bench_components: cannot load %s\n", AMBIENT_SAMPLE_BLOB);
+        return 1;
+    }
+    PrepareSampleCopies();
+
+    printf("component,sample_rate,block,ns_per_sample,budget_pct\n");
+    for(const Component& c : kComponents) {
+        if(only && strcmp(only, c.name) != 0) {
+            continue;
+        }
+        if(!adpcm_bytes && strcmp(c.name, "decode_adpcm") == 0) {
+            continue;
+        }
+        for(float sr : kSampleRates) {
+            for(size_t block : kBlocks) {
+                double ns = 1e30;
+                for(int r = 0; r < repeats; r++) {
+                    const double t = TimeRun(c, sr, block, seconds);
+                    ns             = t < ns ? t : ns;
+                }
+                printf("%s,%.0f,%zu,%.2f,%.3f\n", c.name, sr, block, ns, 100.0 * ns * sr / 1e9);
+                fflush(stdout);
+            }
+        }
+    }
+
+    // Keeps the renders observable; not part of the CSV.
+    fprintf(stderr, "checksum %.6f\n", checksum);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// bench_control_rate.cpp
+// Cost of the modulated voices at different control periods. Renders the full
+// engine and the DroneBank alone at N = 1 (audio-rate modulation), 16, 32 and 48,
+// interleaving the runs and keeping the fastest of each so machine noise
+// cancels out, and prints ns/sample and the saving against N = 1.
+//
+//   bench_control_rate [seconds] [repeats]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "ambient_engine.h"
+#include "drone_bank.h"
+#include "sample_data.h"
+
+static const uint32_t kPeriods[] = {1, 16, 32, 48};
+static const int      kNumPeriods = sizeof(kPeriods) / sizeof(kPeriods[0]);
+
+static ambient::DelayBuffer delay;
+static ambient::Engine      engine;
+static ambient::DroneBank   bank;
+
+static const float  kSampleRate = 48000.0f;
+static const size_t kBlock      = 48;
+
+static double TimeEngine(uint32_t period, size_t blocks) {
+    static float out[kBlock * 2];
+    engine.Init(kSampleRate, &delay);
+    engine.SetControlPeriod(period);
+
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t b = 0; b < blocks; b++) {
+        engine.Process(out, kBlock * 2);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double TimeDrones(uint32_t period, size_t blocks) {
+    static float buf[3][kBlock];
+    float* const out[3] = {buf[0], buf[1], buf[2]};
+    bank.Init(kSampleRate, ambient::kDroneParams);
+    bank.SetControlPeriod(period);
+    for(int v = 0; v < 3; v++) {
+        bank.SetFreq(v, 110.0f * static_cast<float>(v + 1));
+        bank.SetGate(v, true);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t b = 0; b < blocks; b++) {
+        bank.Process(out, kBlock);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const float seconds = argc > 1 ? static_cast<float>(atof(argv[1])) : 30.0f;
+    const int   repeats = argc > 2 ? atoi(argv[2]) : 5;
+    const size_t blocks = static_cast<size_t>(seconds * kSampleRate) / kBlock;
+
+    if(blocks == 0 || repeats <= 0) {
+        fprintf(stderr, "usage: bench_control_rate [seconds] [repeats]\n");
+        return 1;
+    }
+
+    if(!MapSampleData(AMBIENT_SAMPLE_BLOB)) {
+        fprintf(stderr, "bench_control_rate: sample blob missing, sample layer is silent\n");
+    }
+
+    double engine_best[kNumPeriods];
+    double drones_best[kNumPeriods];
+    for(int p = 0; p < kNumPeriods; p++) {
+        engine_best[p] = 1e30;
+        drones_best[p] = 1e30;
+    }
+
+    for(int r = 0; r < repeats; r++) {
+        for(int p = 0; p < kNumPeriods; p++) {
+            const double e = TimeEngine(kPeriods[p], blocks);
+            const double d = TimeDrones(kPeriods[p], blocks);
+            engine_best[p] = e < engine_best[p] ? e : engine_best[p];
+            drones_best[p] = d < drones_best[p] ? d : drones_best[p];
+        }
+    }
+
+    const double samples = static_cast<double>(blocks * kBlock);
+    printf("period  engine ns/sample  saved    drones ns/sample  saved\n");
+    for(int p = 0; p < kNumPeriods; p++) {
+        printf("%6u  %16.2f  %5.1f%%  %16.2f  %5.1f%%\n", kPeriods[p],
+               engine_best[p] * 1e9 / samples, 100.0 * (1.0 - engine_best[p] / engine_best[0]),
+               drones_best[p] * 1e9 / samples, 100.0 * (1.0 - drones_best[p] / drones_best[0]));
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+// bench_drones.cpp
+// DroneBank vs. the original drones[3] path (three DroneVoice structs, each
+// daisysp::Oscillator x2 -> Svf -> Adsr with a triangle cutoff LFO).
+// Renders the same gate/pitch script through both and prints time per sample
+// and the largest output difference.
+//
+//   bench_drones [seconds] [block]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "drone_bank.h"
+#include "drone_voice_ref.h"
+
+static DroneVoice         drones[3];
+static ambient::DroneBank bank;
+
+static void InitReference(float sample_rate) {
+    for(int i = 0; i < 3; i++) {
+        InitDroneVoice(drones[i], ambient::kDroneParams[i], sample_rate);
+    }
+}
+
+static void ProcessReference(float* const out[3], size_t size) {
+    for(int di = 0; di < 3; di++) {
+        RenderDroneVoice(drones[di], out[di], size);
+    }
+}
+
+// Gate/pitch script: every voice retriggers on its own period so all ADSR
+// segments and pitch jumps are exercised.
+static void Script(size_t block_index, bool gates[3], float freqs[3]) {
+    static const float notes[4] = {130.81f, 164.81f, 196.0f, 261.63f};
+    for(int v = 0; v < 3; v++) {
+        const size_t period = 2000 + 700 * v;
+        const size_t phase  = block_index % period;
+        gates[v]            = phase < period * 3 / 4;
+        freqs[v]            = notes[(block_index / period + v) % 4];
+    }
+}
+
+int main(int argc, char** argv) {
+    const float  sample_rate = 48000.0f;
+    const float  seconds     = argc > 1 ? static_cast<float>(atof(argv[1])) : 60.0f;
+    const size_t block       = argc > 2 ? static_cast<size_t>(atoi(argv[2])) : 48;
+    const size_t blocks      = static_cast<size_t>(seconds * sample_rate) / block;
+
+    static float ref_buf[3][4096];
+    static float bank_buf[3][4096];
+    float* const ref_out[3]  = {ref_buf[0], ref_buf[1], ref_buf[2]};
+    float* const bank_out[3] = {bank_buf[0], bank_buf[1], bank_buf[2]};
+
+    if(block == 0 || block > 4096) {
+        fprintf(stderr, "usage: bench_drones [seconds] [block<=4096]\n");
+        return 1;
+    }
+
+    InitReference(sample_rate);
+    bank.Init(sample_rate, ambient::kDroneParams);
+    bank.SetControlPeriod(1); // audio-rate cutoff, like the reference
+
+    double ref_sec = 0.0, bank_sec = 0.0, max_diff = 0.0, checksum = 0.0;
+
+    for(size_t b = 0; b < blocks; b++) {
+        bool  gates[3];
+        float freqs[3];
+        Script(b, gates, freqs);
+        for(int v = 0; v < 3; v++) {
+            drones[v].env_gate     = gates[v];
+            drones[v].current_freq = freqs[v];
+            bank.SetGate(v, gates[v]);
+            if(bank.Freq(v) != freqs[v]) {
+                bank.SetFreq(v, freqs[v]);
+            }
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        ProcessReference(ref_out, block);
+        auto t1 = std::chrono::steady_clock::now();
+        bank.Process(bank_out, block);
+        auto t2 = std::chrono::steady_clock::now();
+
+        ref_sec += std::chrono::duration<double>(t1 - t0).count();
+        bank_sec += std::chrono::duration<double>(t2 - t1).count();
+
+        for(int v = 0; v < 3; v++) {
+            for(size_t i = 0; i < block; i++) {
+                const double d = fabs(static_cast<double>(ref_buf[v][i]) - bank_buf[v][i]);
+                max_diff       = d > max_diff ? d : max_diff;
+                checksum += bank_buf[v][i];
+            }
+        }
+    }
+
+    const double samples = static_cast<double>(blocks * block);
+    printf("drones[3] reference: %7.2f ns/sample\n", ref_sec * 1e9 / samples);
+    printf("DroneBank          : %7.2f ns/sample (%.2fx)\n", bank_sec * 1e9 / samples, ref_sec / bank_sec);
+    printf("max |diff|         : %.3g (checksum %.6f)\n", max_diff, checksum);
+    return 0;
+}
@@ -0,0 +1,201 @@
+// control_queue_stress.cpp
+// Hammers the main-loop/audio-callback primitives from two threads:
+//   - SpscQueue: the producer pushes numbered messages as fast as it can, the
+//     consumer checks that every accepted message arrives once and in order.
+//   - SeqlockSnapshot: the writer publishes snapshots whose fields all carry the
+//     same counter, the reader checks it never sees a mix of two snapshots.
+//   - Engine: a "main loop" thread posts tempo changes and nudges and reads meters
+//     while an "audio" thread renders.
+// Exits nonzero on any violation. Build with OPT="-O1 -g -fsanitize=thread" to
+// let ThreadSanitizer watch the same runs.
+//
+//   control_queue_stress [seconds]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "ambient_engine.h"
+#include "sample_data.h"
+#include "seqlock.h"
+#include "spsc_queue.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Numbered {
+    uint64_t seq;
+    uint32_t check; // derived from seq to catch torn items
+};
+
+struct Wide {
+    uint32_t a[12];
+    uint64_t b;
+};
+
+static bool QueueTest(double seconds) {
+    static ambient::SpscQueue<Numbered, 64> queue;
+    std::atomic<bool>     stop{false};
+    std::atomic<uint64_t> pushed{0};
+    uint64_t              received = 0;
+    uint64_t              errors   = 0;
+
+    std::thread producer([&] {
+        uint64_t next = 0;
+        while(!stop.load(std::memory_order_relaxed)) {
+            if(queue.Push(Numbered{next, static_cast<uint32_t>(next * 2654435761u)})) {
+                next++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        pushed.store(next);
+    });
+
+    const auto deadline = Clock::now() + std::chrono::duration<double>(seconds);
+    Numbered   item;
+    while(Clock::now() < deadline) {
+        for(int i = 0; i < 256; i++) {
+            if(!queue.Pop(item)) {
+                std::this_thread::yield();
+                break;
+            }
+            if(item.seq != received || item.check != static_cast<uint32_t>(item.seq * 2654435761u)) {
+                errors++;
+            }
+            received = item.seq + 1;
+        }
+    }
+    stop.store(true);
+    producer.join();
+    while(queue.Pop(item)) {
+        if(item.seq != received) {
+            errors++;
+        }
+        received = item.seq + 1;
+    }
+
+    const bool ok = errors == 0 && received == pushed.load();
+    printf("spsc queue   : %llu messages, %llu errors, %s\n",
+           static_cast<unsigned long long>(received),
+           static_cast<unsigned long long>(errors),
+           ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool SeqlockTest(double seconds) {
+    static ambient::SeqlockSnapshot<Wide> snapshot;
+    std::atomic<bool> stop{false};
+    uint64_t          reads = 0, retries = 0, errors = 0;
+
+    std::thread writer([&] {
+        Wide     w;
+        uint64_t n = 0;
+        while(!stop.load(std::memory_order_relaxed)) {
+            n++;
+            for(int i = 0; i < 12; i++) {
+                w.a[i] = static_cast<uint32_t>(n);
+            }
+            w.b = n;
+            snapshot.Write(w);
+        }
+    });
+
+    const auto deadline = Clock::now() + std::chrono::duration<double>(seconds);
+    uint64_t   last     = 0;
+    while(Clock::now() < deadline) {
+        Wide w;
+        if(!snapshot.TryRead(w)) {
+            retries++;
+            continue;
+        }
+        reads++;
+        for(int i = 0; i < 12; i++) {
+            if(w.a[i] != static_cast<uint32_t>(w.b)) {
+                errors++;
+                break;
+            }
+        }
+        if(w.b < last) {
+            errors++;
+        }
+        last = w.b;
+    }
+    stop.store(true);
+    writer.join();
+
+    const bool ok = errors == 0 && reads > 0;
+    printf("seqlock      : %llu reads, %llu retries, %llu torn, %s\n",
+           static_cast<unsigned long long>(reads),
+           static_cast<unsigned long long>(retries),
+           static_cast<unsigned long long>(errors),
+           ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static ambient::DelayBuffer delay;
+static ambient::Engine      engine;
+
+static bool EngineTest(double seconds) {
+    engine.Init(48000.0f, &delay);
+    std::atomic<bool> stop{false};
+
+    std::thread audio([&] {
+        float out[48 * 2];
+        while(!stop.load(std::memory_order_relaxed)) {
+            engine.Process(out, 48 * 2);
+        }
+    });
+
+    const auto deadline = Clock::now() + std::chrono::duration<double>(seconds);
+    uint64_t   posted = 0, full = 0, errors = 0, last_clock = 0;
+    uint32_t   n      = 0;
+    while(Clock::now() < deadline) {
+        engine.PrepareNextCycle();
+        const bool ok = (n % 64 == 0) ? engine.RequestRootNudge()
+                                      : engine.SetBpm(30.0f + static_cast<float>(n % 91));
+        ok ? posted++ : full++;
+        n++;
+        if(!ok) {
+            std::this_thread::yield();
+        }
+
+        const ambient::MeterSnapshot m = engine.Meters();
+        for(int i = 0; i < 6; i++) {
+            if(!(m.led_levels[i] >= 0.0f && m.led_levels[i] <= 1.0f)) {
+                errors++;
+            }
+            // RMS never exceeds peak within one block; a torn snapshot could mix two.
+            if(!(m.bus_rms[i] <= m.bus_peak[i] * 1.0001f)) {
+                errors++;
+            }
+        }
+        if(m.sample_clock < last_clock) {
+            errors++;
+        }
+        last_clock = m.sample_clock;
+    }
+    stop.store(true);
+    audio.join();
+
+    const ambient::MeterSnapshot m  = engine.Meters();
+    const bool                   ok = errors == 0 && m.sample_clock > 0;
+    printf("engine       : %llu posted, %llu queue-full, %.1f s rendered, %u inline ticks, %s\n",
+           static_cast<unsigned long long>(posted),
+           static_cast<unsigned long long>(full),
+           static_cast<double>(m.sample_clock) / 48000.0,
+           m.sequencer_underruns,
+           ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    MapSampleData(AMBIENT_SAMPLE_BLOB); // silent sample layer if missing; not under test here
+
+    bool ok = QueueTest(seconds);
+    ok      = SeqlockTest(seconds) && ok;
+    ok      = EngineTest(seconds) && ok;
+    return ok ? 0 : 1;
+}
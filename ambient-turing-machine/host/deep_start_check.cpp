@@ -0,0 +1,120 @@
+// deep_start_check.cpp
+// Checks the deep-start limit documented in render_cli.cpp and render_farm.cpp.
+// The follower degrees drift up by the same amount every sequencer period and V4
+// and V6 only fold down at fixed notes, so the followers keep climbing:
+//   - the first follower above MIDI 127 comes after kUsableCycles, and no more
+//     than 100 cycles after it, whatever the nudges. If this fails, the sequencer
+//     changed: move the documented limit with it;
+//   - renders starting at cycles up to kUsableCycles do not clip and stay within
+//     6 dB above the level of a render from cycle 0.
+// A render from kDeepCycles is printed for reference. It clips with the daisysp
+// pad oscillators and aliases with OSC=wavetable, so it is not checked.
+// Exits non-zero on any failure.
+//
+//   deep_start_check [seconds]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "ambient_engine.h"
+#include "sample_data.h"
+#include "sequencer_state_check.h"
+
+// Keep in step with render_cli.cpp and render_farm.cpp.
+static const uint32_t kUsableCycles = 3000;
+static const uint32_t kDeepCycles   = 6000;
+
+static const uint32_t kStarts[]  = {0, 1000, 2000, kUsableCycles};
+static const int      kNumStarts = sizeof(kStarts) / sizeof(kStarts[0]);
+
+static const float  kSampleRate = 48000.0f;
+static const float  kBpm        = 50.0f;
+static const size_t kBlock      = 48;
+
+static ambient::DelayBuffer delay;
+static ambient::Engine      engine;
+
+// First cycle at which a follower (V2, V4, V6) is above MIDI 127, after `nudges`
+// root nudges (each moves the cycle on to the next multiple of 12), or `limit`.
+static uint32_t FirstOutOfRange(int nudges, uint32_t limit) {
+    turing::SequencerState s = Start(nudges);
+    while(s.cycle < limit) {
+        turing::sequencer_tick(s);
+        for(int v = 1; v < 6; v += 2) {
+            if(s.voices[v].midi_note > 127) {
+                return s.cycle;
+            }
+        }
+    }
+    return limit;
+}
+
+struct Level {
+    double   rms;
+    float    peak;
+    uint64_t clipped; // samples at or beyond full scale
+};
+
+static Level Render(uint32_t start_cycle, float seconds) {
+    engine.Init(kSampleRate, &delay, 0, start_cycle);
+    engine.SetBpm(kBpm);
+
+    static float   buffer[kBlock * 2];
+    const uint64_t frames = static_cast<uint64_t>(seconds * kSampleRate);
+    double         sum    = 0.0;
+    Level          level  = {0.0, 0.0f, 0};
+    for(uint64_t done = 0; done < frames; done += kBlock) {
+        engine.Process(buffer, kBlock * 2);
+        for(size_t i = 0; i < kBlock * 2; i++) {
+            const float a = fabsf(buffer[i]);
+            sum += static_cast<double>(buffer[i]) * buffer[i];
+            level.peak = a > level.peak ? a : level.peak;
+            level.clipped += a >= 1.0f ? 1 : 0;
+        }
+        engine.PrepareNextCycle();
+    }
+    level.rms = sqrt(sum / static_cast<double>(frames * 2));
+    return level;
+}
+
+static void PrintLevel(uint32_t start_cycle, const Level& l, double reference, const char* verdict) {
+    printf("start %5u: rms %.4f (%+5.1f dB) peak %.3f, %8llu clipped  %s\n", start_cycle, l.rms,
+           20.0 * log10(l.rms / reference), l.peak, static_cast<unsigned long long>(l.clipped), verdict);
+}
+
+int main(int argc, char** argv) {
+    const float seconds = argc > 1 ? static_cast<float>(atof(argv[1])) : 30.0f;
+    int         bad     = 0;
+
+    uint32_t earliest = 0xFFFFFFFFu;
+    for(int nudges = 0; nudges < 12; nudges++) {
+        const uint32_t c = FirstOutOfRange(nudges, 100000);
+        earliest         = c < earliest ? c : earliest;
+    }
+    const bool in_range = earliest > kUsableCycles && earliest <= kUsableCycles + 100;
+    printf("first follower above MIDI 127 at cycle %u (limit %u): %s\n", earliest, kUsableCycles, in_range ? "ok" : "FAIL");
+    bad += in_range ? 0 : 1;
+
+    if(!MapSampleData(AMBIENT_SAMPLE_BLOB)) {
+        fprintf(stderr, "deep_start_check: cannot load %s\n", AMBIENT_SAMPLE_BLOB);
+        return 1;
+    }
+
+    double reference = 0.0;
+    for(int i = 0; i < kNumStarts; i++) {
+        const Level l = Render(kStarts[i], seconds);
+        reference     = i == 0 ? l.rms : reference;
+        const bool ok = l.clipped == 0 && l.rms <= 2.0 * reference;
+        PrintLevel(kStarts[i], l, reference, ok ? "ok" : "FAIL");
+        bad += ok ? 0 : 1;
+    }
+
+    PrintLevel(kDeepCycles, Render(kDeepCycles, seconds), reference, "(past the limit)");
+
+    if(bad > 0) {
+        printf("FAIL: %d checks\n", bad);
+        return 1;
+    }
+    return 0;
+}
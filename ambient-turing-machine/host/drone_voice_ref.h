@@ -0,0 +1,74 @@
+// drone_voice_ref.h
+// The pre-bank drone voice (daisysp::Oscillator x2 -> Svf -> Adsr with an
+// audio-rate triangle cutoff LFO), rendered exactly as the engine used to.
+// Kept for host benchmarks and as the DroneBank accuracy reference.
+
+#ifndef DRONE_VOICE_REF_H
+#define DRONE_VOICE_REF_H
+
+#include <cmath>
+#include <cstddef>
+
+#include "daisysp.h"
+#include "drone_bank.h"
+
+struct DroneVoice {
+    daisysp::Oscillator osc1;
+    daisysp::Oscillator osc2;
+    daisysp::Svf        filter;
+    daisysp::Adsr       env;
+    daisysp::Oscillator filter_lfo;
+    bool                env_gate;
+    float               current_freq;
+    float               detune_cents;
+    float               volume;
+    float               base_filter_freq;
+    float               lfo_depth;
+};
+
+inline void InitDroneVoice(DroneVoice& d, const ambient::DroneParams& p, float sample_rate) {
+    using daisysp::Oscillator;
+    d.osc1.Init(sample_rate);
+    d.osc1.SetWaveform(Oscillator::WAVE_POLYBLEP_SAW);
+    d.osc1.SetAmp(1.0f);
+    d.osc2.Init(sample_rate);
+    d.osc2.SetWaveform(Oscillator::WAVE_POLYBLEP_SAW);
+    d.osc2.SetAmp(1.0f);
+    d.filter.Init(sample_rate);
+    d.filter.SetFreq(p.filter_freq);
+    d.filter.SetRes(p.filter_res);
+    d.env.Init(sample_rate);
+    d.env.SetTime(daisysp::ADSR_SEG_ATTACK, p.attack);
+    d.env.SetTime(daisysp::ADSR_SEG_DECAY, p.decay);
+    d.env.SetSustainLevel(p.sustain);
+    d.env.SetTime(daisysp::ADSR_SEG_RELEASE, p.release);
+    d.filter_lfo.Init(sample_rate);
+    d.filter_lfo.SetWaveform(Oscillator::WAVE_TRI);
+    d.filter_lfo.SetFreq(p.lfo_rate);
+    d.filter_lfo.SetAmp(1.0f);
+    d.env_gate         = false;
+    d.current_freq     = 130.81f;
+    d.detune_cents     = p.detune_cents;
+    d.volume           = p.volume;
+    d.base_filter_freq = p.filter_freq;
+    d.lfo_depth        = p.lfo_depth;
+}
+
+inline void RenderDroneVoice(DroneVoice& d, float* out, size_t size) {
+    d.osc1.SetFreq(d.current_freq);
+    const float detune_ratio = powf(2.0f, d.detune_cents / 1200.0f);
+    d.osc2.SetFreq(d.current_freq * detune_ratio);
+    for(size_t i = 0; i < size; i++) {
+        float lfo_val = d.filter_lfo.Process();
+        float cutoff  = d.base_filter_freq + (lfo_val * d.lfo_depth);
+        cutoff        = fmaxf(200.0f, fminf(2000.0f, cutoff));
+        d.filter.SetFreq(cutoff);
+        float sig = (d.osc1.Process() + d.osc2.Process()) * 0.5f;
+        d.filter.Process(sig);
+        sig             = d.filter.Low();
+        const float amp = d.env.Process(d.env_gate);
+        out[i]          = sig * (amp * d.volume);
+    }
+}
+
+#endif // DRONE_VOICE_REF_H
@@ -0,0 +1,135 @@
+// fast_math_check.cpp
+// Accuracy and throughput of fast_math.h against libm.
+// Prints the worst relative error per function over its documented range and
+// ns per call for each fast kernel next to the powf expression it replaces.
+// Exits non-zero if any error exceeds the bound stated in fast_math.h.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "fast_math.h"
+
+static volatile float sink;
+
+struct ErrorStat {
+    double worst;
+    double at;
+};
+
+template <typename Fast, typename Ref>
+static ErrorStat SweepError(float lo, float hi, float step, Fast fast, Ref ref) {
+    ErrorStat stat = {0.0, 0.0};
+    for(double x = lo; x <= hi; x += step) {
+        // Compare against the exact result for the float the kernel actually sees.
+        const float  xf    = static_cast<float>(x);
+        const double exact = ref(static_cast<double>(xf));
+        const double err   = fabs(static_cast<double>(fast(xf)) / exact - 1.0);
+        if(err > stat.worst) {
+            stat.worst = err;
+            stat.at    = x;
+        }
+    }
+    return stat;
+}
+
+// Block throughput: the same shape as a per-sample modulation loop.
+template <typename Fn>
+static double NsPerCall(Fn fn) {
+    static float in[1024];
+    static float out[1024];
+    for(int i = 0; i < 1024; i++) {
+        in[i] = static_cast<float>(i) * (1.0f / 1024.0f) - 0.5f;
+    }
+    const int  passes = 4096;
+    const auto t0     = std::chrono::steady_clock::now();
+    for(int p = 0; p < passes; p++) {
+        for(int i = 0; i < 1024; i++) {
+            out[i] = fn(in[i]);
+        }
+        sink = out[p & 1023];
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (1024.0 * passes);
+}
+
+static bool Report(const char* name, ErrorStat stat, double bound) {
+    const bool ok = stat.worst <= bound;
+    printf("%-22s max rel err %.3g (at %g)  bound %.1g  %s\n", name, stat.worst, stat.at, bound, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+
+    ok &= Report("exp2f_fast",
+                 SweepError(-20.0f, 20.0f, 1.0e-4f, fastmath::exp2f_fast, [](double x) { return exp2(x); }),
+                 3e-7);
+    ok &= Report("cents_to_ratio",
+                 SweepError(-2400.0f, 2400.0f, 0.01f, fastmath::cents_to_ratio,
+                            [](double c) { return exp2(c / 1200.0); }),
+                 4e-7);
+    ok &= Report("midi_to_freq(float)",
+                 SweepError(0.0f, 127.0f, 1.0e-3f, [](float m) { return fastmath::midi_to_freq(m); },
+                            [](double m) { return 440.0 * exp2((m - 69.0) / 12.0); }),
+                 6e-7);
+
+    ErrorStat midi_int = {0.0, 0.0};
+    for(int m = 0; m <= 127; m++) {
+        const double exact = 440.0 * exp2((m - 69) / 12.0);
+        const double err   = fabs(fastmath::midi_to_freq(m) / exact - 1.0);
+        if(err > midi_int.worst) {
+            midi_int.worst = err;
+            midi_int.at    = m;
+        }
+    }
+    ok &= Report("midi_to_freq(int)", midi_int, 1e-7);
+
+    // Far outside MIDI: the notes the Wanderer and Echo reach in long runs. Finite
+    // where powf is (within the same bound), +inf where it overflows, never negative.
+    midi_int          = {0.0, 0.0};
+    bool range_ok     = true;
+    int  range_bad_at = 0;
+    for(int m = -100000; m <= 100000; m++) {
+        const float  fast = fastmath::midi_to_freq(m);
+        const float  ref  = 440.0f * powf(2.0f, static_cast<float>(m - 69) / 12.0f);
+        const double exact = 440.0 * exp2((m - 69) / 12.0);
+        if(std::isinf(ref)) {
+            range_ok = range_ok && std::isinf(fast) && fast > 0.0f;
+        } else if(exact >= 1e-30) {
+            const double err = fabs(fast / exact - 1.0);
+            if(err > midi_int.worst) {
+                midi_int.worst = err;
+                midi_int.at    = m;
+            }
+        } else {
+            range_ok = range_ok && fast >= 0.0f && fast < 1e-30f;
+        }
+        if(!range_ok && range_bad_at == 0) {
+            range_bad_at = m;
+        }
+    }
+    static const int kFar[] = {1536, 1700, 100000, 1 << 30, 0x7FFFFFFF};
+    for(int m : kFar) {
+        const float fast = fastmath::midi_to_freq(m);
+        range_ok         = range_ok && std::isinf(fast) && fast > 0.0f;
+        range_bad_at     = range_ok || range_bad_at != 0 ? range_bad_at : m;
+    }
+    ok &= Report("midi_to_freq(int) wide", midi_int, 1e-7);
+    if(range_ok) {
+        printf("%-22s +inf from MIDI 1500, positive below  ok\n", "midi_to_freq(int) out");
+    } else {
+        printf("%-22s wrong sign or overflow at %d  FAIL\n", "midi_to_freq(int) out", range_bad_at);
+    }
+    ok &= range_ok;
+
+    printf("\nthroughput (ns/call)\n");
+    printf("powf(2, c / 1200)      %6.2f\n", NsPerCall([](float c) { return powf(2.0f, c * 100.0f / 1200.0f); }));
+    printf("cents_to_ratio         %6.2f\n", NsPerCall([](float c) { return fastmath::cents_to_ratio(c * 100.0f); }));
+    printf("440 * powf(2, n / 12)  %6.2f\n", NsPerCall([](float n) { return 440.0f * powf(2.0f, (n * 100.0f) / 12.0f); }));
+    printf("midi_to_freq(float)    %6.2f\n", NsPerCall([](float n) { return fastmath::midi_to_freq(n * 100.0f + 69.0f); }));
+    printf("midi_to_freq(int)      %6.2f\n",
+           NsPerCall([](float n) { return fastmath::midi_to_freq(static_cast<int>(n * 100.0f) + 64); }));
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "pipelined_engine.h"
+
+#include <cstring>
+
+#include "denormals.h"
+
+namespace host {
+
+// Waits for `ready` to hold. Returns false if the pipeline is stopping instead.
+template <typename Ready>
+static bool WaitFor(const std::atomic<bool>& stop, Ready ready) {
+    while(!ready()) {
+        if(stop.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void PipelinedEngine::Init(float sample_rate, ambient::DelayBuffer* delay, int start_root, uint32_t start_cycle) {
+    Stop();
+    engine_.Init(sample_rate, delay, start_root, start_cycle);
+
+    blocks_ = 0;
+    leader_start_.store(0, std::memory_order_relaxed);
+    leader_done_.store(0, std::memory_order_relaxed);
+    effect_start_.store(0, std::memory_order_relaxed);
+    effect_done_.store(0, std::memory_order_relaxed);
+    stop_.store(false, std::memory_order_relaxed);
+
+    leader_ = std::thread([this]() { LeaderLoop(); });
+    effect_ = std::thread([this]() { EffectLoop(); });
+}
+
+void PipelinedEngine::Stop() {
+    stop_.store(true, std::memory_order_relaxed);
+    if(leader_.joinable()) {
+        leader_.join();
+    }
+    if(effect_.joinable()) {
+        effect_.join();
+    }
+}
+
+void PipelinedEngine::Process(float* out, size_t size) {
+    const ambient::ScopedFlushDenormals flush_denormals;
+
+    size_t frames = size / 2;
+    if(frames > kMaxFrames) {
+        frames = kMaxFrames;
+    }
+
+    const uint64_t block = blocks_;
+    Slot&          slot  = slots_[block & 1u];
+
+    // The effect stage finished with this slot during the previous call.
+    slot.runs_ready.store(0, std::memory_order_relaxed);
+    slot.runs_total.store(kOpen, std::memory_order_relaxed);
+    leader_start_.store(block + 1, std::memory_order_release);
+
+    // Voice stage; the leader worker renders each run as soon as it is recorded.
+    uint32_t runs   = 0;
+    size_t   offset = 0;
+    while(offset < frames) {
+        ambient::Engine::RunRecord& run = slot.runs[runs];
+        engine_.RenderVoiceRun(frames - offset, slot.Buses(offset), run);
+        offset += run.frames;
+        slot.runs_ready.store(++runs, std::memory_order_release);
+    }
+    slot.status = engine_.VoiceStatus();
+    slot.runs_total.store(runs, std::memory_order_release);
+
+    // The previous block's effects ran alongside; hand this block over once its
+    // leaders are done too.
+    WaitFor(stop_, [&]() { return leader_done_.load(std::memory_order_acquire) > block; });
+    WaitFor(stop_, [&]() { return effect_done_.load(std::memory_order_acquire) >= block; });
+
+    if(block > 0) {
+        memcpy(out, slots_[(block - 1) & 1u].out, sizeof(float) * frames * 2);
+    } else {
+        memset(out, 0, sizeof(float) * frames * 2);
+    }
+    effect_start_.store(block + 1, std::memory_order_release);
+    blocks_ = block + 1;
+}
+
+void PipelinedEngine::LeaderLoop() {
+    for(uint64_t block = 0;; block++) {
+        if(!WaitFor(stop_, [&]() { return leader_start_.load(std::memory_order_acquire) > block; })) {
+            return;
+        }
+        const ambient::ScopedFlushDenormals flush_denormals;
+        Slot&                               slot   = slots_[block & 1u];
+        size_t                              offset = 0;
+        for(uint32_t r = 0;; r++) {
+            const bool more = WaitFor(stop_, [&]() {
+                return r < slot.runs_ready.load(std::memory_order_acquire)
+                       || r >= slot.runs_total.load(std::memory_order_acquire);
+            });
+            if(!more) {
+                return;
+            }
+            if(r >= slot.runs_ready.load(std::memory_order_acquire)) {
+                break; // block closed
+            }
+            engine_.RenderLeaderRun(slot.runs[r], slot.Buses(offset));
+            offset += slot.runs[r].frames;
+        }
+        leader_done_.store(block + 1, std::memory_order_release);
+    }
+}
+
+void PipelinedEngine::EffectLoop() {
+    for(uint64_t block = 0;; block++) {
+        if(!WaitFor(stop_, [&]() { return effect_start_.load(std::memory_order_acquire) > block; })) {
+            return;
+        }
+        const ambient::ScopedFlushDenormals flush_denormals;
+        Slot&                               slot   = slots_[block & 1u];
+        const uint32_t                      runs   = slot.runs_total.load(std::memory_order_relaxed);
+        size_t                              offset = 0;
+        for(uint32_t r = 0; r < runs; r++) {
+            engine_.RenderEffectRun(slot.runs[r], slot.Buses(offset), slot.out + offset * 2);
+            offset += slot.runs[r].frames;
+        }
+        engine_.FinishBlock(slot.status);
+        effect_done_.store(block + 1, std::memory_order_release);
+    }
+}
+
+} // namespace host
@@ -0,0 +1,99 @@
+// pipelined_engine.h
+// Pipelined Engine — ambient::Engine Split Across Three Threads
+// Runs the engine's stages (see "Staged processing" in ambient_engine.h) on
+// separate cores for host playback at high voice counts:
+//   - the calling (audio) thread runs the voice stage: controls, sequencer events,
+//     sparkle and pad voices;
+//   - a leader worker renders the drones and the sampler, following the voice
+//     stage run by run through the block;
+//   - an effect worker mixes the finished block through the delays and reverb and
+//     publishes the meters, while the next block's voices render.
+// Blocks move between stages through two bus slots (double buffering); each slot
+// changes hands through atomic counters, with no locks. The price is one block of
+// latency: Process returns the previous call's audio (silence on the first call).
+// The samples are bit-identical to Engine::Process, one block later.
+//
+// Every Process call must pass the same size, as an audio callback does. Workers
+// wait by spinning with yield, so each wants a core of its own. Engine calls that
+// post controls, read meters or prepare cycles work as usual from the main loop;
+// SetControlPeriod and ReportLoad belong between Process calls on the audio thread.
+// Not for PROFILE=1 builds: the stage profiler is single-threaded.
+
+#ifndef HOST_PIPELINED_ENGINE_H
+#define HOST_PIPELINED_ENGINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "ambient_engine.h"
+
+namespace host {
+
+class PipelinedEngine {
+  public:
+    static const size_t kMaxFrames = 4096; // per Process call
+
+    PipelinedEngine() {}
+    ~PipelinedEngine() { Stop(); }
+
+    // Initialises the engine and starts the workers.
+    void Init(float sample_rate, ambient::DelayBuffer* delay, int start_root = 0, uint32_t start_cycle = 0);
+
+    // Joins the workers; Init starts them again.
+    void Stop();
+
+    // Submits `size` samples (frames * 2) of new audio and returns the previous
+    // call's. Same convention as Engine::Process.
+    void Process(float* out, size_t size);
+
+    ambient::Engine&       GetEngine() { return engine_; }
+    const ambient::Engine& GetEngine() const { return engine_; }
+
+  private:
+    struct Slot {
+        float drone[3][kMaxFrames];
+        float sparkle[2][kMaxFrames];
+        float pad[kMaxFrames];
+        float sampler[kMaxFrames];
+        float out[kMaxFrames * 2];
+
+        ambient::Engine::RunRecord  runs[kMaxFrames]; // at most one run per frame
+        ambient::Engine::BlockStatus status;
+
+        std::atomic<uint32_t> runs_ready; // runs the voice stage has recorded
+        std::atomic<uint32_t> runs_total; // final run count, or kOpen while rendering
+
+        ambient::Engine::VoiceBuses Buses(size_t offset) {
+            return ambient::Engine::VoiceBuses{{drone[0] + offset, drone[1] + offset, drone[2] + offset},
+                                               {sparkle[0] + offset, sparkle[1] + offset},
+                                               pad + offset,
+                                               sampler + offset};
+        }
+    };
+
+    static const uint32_t kOpen = 0xFFFFFFFFu;
+
+    void LeaderLoop();
+    void EffectLoop();
+
+    ambient::Engine engine_;
+    Slot            slots_[2];
+    uint64_t        blocks_; // Process calls so far
+
+    // Block counters: a worker runs block n (slot n % 2) once start > n and
+    // reports it by setting done to n + 1.
+    std::atomic<uint64_t> leader_start_;
+    std::atomic<uint64_t> leader_done_;
+    std::atomic<uint64_t> effect_start_;
+    std::atomic<uint64_t> effect_done_;
+    std::atomic<bool>     stop_;
+
+    std::thread leader_;
+    std::thread effect_;
+};
+
+} // namespace host
+
+#endif // HOST_PIPELINED_ENGINE_H
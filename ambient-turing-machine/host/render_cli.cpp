@@ -0,0 +1,212 @@
+// render_cli.cpp
+// Offline renderer: runs ambient::Engine as fast as the CPU allows and
+// writes the result to a WAV file.
+//
+//   render --minutes 10 --out ambient.wav [--rate 48000] [--bpm 50]
+//          [--block 48] [--format pcm16|float32] [--control-period 32]
+//          [--sample BED.bin] [--cpu-slowdown X] [--pipeline]
+//          [--start-cycle N]
+//
+// --start-cycle N renders from N sequencer cycles in (a constant-time seek).
+// Keep the last cycle rendered at or below 3000 (a cycle is 240 / bpm seconds).
+// The follower degrees drift up every period, so V4/V6 pass MIDI 127 at cycle
+// 3085. From cycle 4561 the pad is played above the sample rate and the output
+// clips hard (--start-cycle 6000: RMS 0.85); OSC=wavetable builds alias instead.
+// host/build/deep_start_check checks the limit.
+//
+// --pipeline renders through host::PipelinedEngine (voices, drones and effects
+// on three threads). Its one block of latency is taken out again, so the file is
+// identical to the single-threaded render.
+//
+// --cpu-slowdown X feeds the engine's CPU budget with each callback's measured
+// time multiplied by X (how much slower the target is than this host), so voice
+// shedding can be heard offline. Without it no load is reported and the render
+// is deterministic.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ambient_engine.h"
+#include "pipelined_engine.h"
+#include "sample_data.h"
+#include "wav_writer.h"
+
+static ambient::DelayBuffer   delay;
+static ambient::Engine        single;
+static host::PipelinedEngine  pipelined;
+
+static void PrintUsage() {
+    fprintf(stderr,
+            "usage: render --minutes N --out FILE.wav [--rate HZ] [--bpm BPM]\n"
+            "              [--block FRAMES] [--format pcm16|float32]\n"
+            "              [--control-period SAMPLES] [--sample BED.bin]\n"
+            "              [--cpu-slowdown X] [--pipeline] [--start-cycle N]\n"
+            "start cycle + cycles rendered should stay at or below 3000: followers leave\n"
+            "the MIDI range past it, and the output clips from cycle 4561\n");
+}
+
+int main(int argc, char** argv) {
+    float       minutes     = 1.0f;
+    const char* out_path    = nullptr;
+    float       sample_rate = 48000.0f;
+    float       bpm         = 50.0f;
+    size_t      block       = 48;
+    uint32_t    control     = ambient::kDefaultControlPeriod;
+    const char* sample_path = AMBIENT_SAMPLE_BLOB;
+    float       slowdown    = 0.0f;
+    bool        pipeline    = false;
+    uint32_t    start_cycle = 0;
+
+    host::WavWriter::Format format = host::WavWriter::FORMAT_PCM16;
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg  = argv[i];
+        if(strcmp(arg, "--pipeline") == 0) {
+            pipeline = true;
+            continue;
+        }
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if(next == nullptr) {
+            PrintUsage();
+            return 1;
+        }
+        if(strcmp(arg, "--minutes") == 0) {
+            minutes = static_cast<float>(atof(next));
+        } else if(strcmp(arg, "--out") == 0) {
+            out_path = next;
+        } else if(strcmp(arg, "--rate") == 0) {
+            sample_rate = static_cast<float>(atof(next));
+        } else if(strcmp(arg, "--bpm") == 0) {
+            bpm = static_cast<float>(atof(next));
+        } else if(strcmp(arg, "--block") == 0) {
+            block = static_cast<size_t>(atoi(next));
+        } else if(strcmp(arg, "--control-period") == 0) {
+            control = static_cast<uint32_t>(atoi(next));
+        } else if(strcmp(arg, "--sample") == 0) {
+            sample_path = next;
+        } else if(strcmp(arg, "--start-cycle") == 0) {
+            start_cycle = static_cast<uint32_t>(strtoul(next, nullptr, 10));
+        } else if(strcmp(arg, "--cpu-slowdown") == 0) {
+            slowdown = static_cast<float>(atof(next));
+        } else if(strcmp(arg, "--format") == 0) {
+            format = strcmp(next, "float32") == 0 ? host::WavWriter::FORMAT_FLOAT32
+                                                  : host::WavWriter::FORMAT_PCM16;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+        i++;
+    }
+
+    if(out_path == nullptr || minutes <= 0.0f || block == 0 || block > 4096 || control == 0) {
+        PrintUsage();
+        return 1;
+    }
+#if defined(AMBIENT_PROFILE)
+    if(pipeline) {
+        fprintf(stderr, "render: --pipeline is not available in PROFILE=1 builds\n");
+        return 1;
+    }
+#endif
+
+    if(!MapSampleData(sample_path)) {
+        fprintf(stderr, "render: cannot load sample blob %s\n", sample_path);
+        return 1;
+    }
+
+    const uint64_t total_frames = static_cast<uint64_t>(minutes * 60.0f * sample_rate);
+    if(total_frames > host::WavWriter::MaxFrames(2, format)) {
+        fprintf(stderr, "render: %.0f minutes is past the 4 GiB WAV limit (%.0f minutes in this format)\n",
+                minutes, static_cast<double>(host::WavWriter::MaxFrames(2, format)) / sample_rate / 60.0);
+        return 1;
+    }
+
+    host::WavWriter wav;
+    if(!wav.Open(out_path, static_cast<uint32_t>(sample_rate), 2, format)) {
+        fprintf(stderr, "render: cannot open %s\n", out_path);
+        return 1;
+    }
+
+    ambient::Engine& engine = pipeline ? pipelined.GetEngine() : single;
+    if(pipeline) {
+        pipelined.Init(sample_rate, &delay, 0, start_cycle);
+    } else {
+        single.Init(sample_rate, &delay, 0, start_cycle);
+    }
+    engine.SetBpm(bpm);
+    engine.SetControlPeriod(control);
+
+    static float   buffer[4096 * 2];
+
+    const auto start = std::chrono::steady_clock::now();
+
+    uint64_t done          = 0;
+    bool     primed        = !pipeline; // the pipeline's first call returns silence
+    int      lowest_budget = ambient::Engine::kSparkleVoices + ambient::Engine::kPadVoices;
+    int      most_voices   = 0;
+    while(done < total_frames) {
+        size_t frames = block;
+        if(total_frames - done < frames) {
+            frames = static_cast<size_t>(total_frames - done);
+        }
+        const auto call_start = std::chrono::steady_clock::now();
+        if(pipeline) {
+            pipelined.Process(buffer, block * 2);
+        } else {
+            engine.Process(buffer, frames * 2);
+        }
+        if(slowdown > 0.0f) {
+            const double call_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - call_start).count();
+            engine.ReportLoad(static_cast<float>(call_sec * slowdown * sample_rate / static_cast<double>(frames)));
+            const ambient::MeterSnapshot m = engine.Meters();
+            lowest_budget = m.voice_budget < lowest_budget ? m.voice_budget : lowest_budget;
+            most_voices   = m.voices_active > most_voices ? m.voices_active : most_voices;
+        }
+        if(primed) {
+            wav.Write(buffer, frames);
+            done += frames;
+        }
+        primed = true;
+        // Stands in for the firmware main loop: keep the next cycle ready.
+        engine.PrepareNextCycle();
+    }
+    pipelined.Stop();
+
+    const auto   stop     = std::chrono::steady_clock::now();
+    const double wall_sec = std::chrono::duration<double>(stop - start).count();
+    const double audio_sec = static_cast<double>(total_frames) / sample_rate;
+
+    if(!wav.Close()) {
+        fprintf(stderr, "render: write to %s failed\n", out_path);
+        return 1;
+    }
+
+    printf("rendered %.1f s of audio in %.3f s (%.1fx realtime) -> %s\n",
+           audio_sec,
+           wall_sec,
+           wall_sec > 0.0 ? audio_sec / wall_sec : 0.0,
+           out_path);
+
+    if(slowdown > 0.0f) {
+        const ambient::MeterSnapshot m = engine.Meters();
+        printf("cpu budget: %u reductions, lowest %d voices, %u at the end (load %.2f); at most %d voices played\n",
+               static_cast<unsigned>(m.voices_shed), lowest_budget, static_cast<unsigned>(m.voice_budget), m.cpu_load,
+               most_voices);
+    }
+
+#if defined(AMBIENT_PROFILE)
+    // Per-callback stage times over the whole render (built with make PROFILE=1).
+    ambient::ProfileReport report;
+    engine.Profiler().Snapshot(report);
+    printf("budget     %lu ns per %zu-frame callback\n",
+           static_cast<unsigned long>(1e9 * static_cast<double>(block) / sample_rate), block);
+    for(int s = 0; s < ambient::PROFILE_STAGE_COUNT; s++) {
+        char line[128];
+        ambient::StageProfiler::FormatLine(report, s, line, sizeof(line));
+        printf("%s\n", line);
+    }
+#endif
+    return 0;
+}
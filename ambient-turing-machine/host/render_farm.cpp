@@ -0,0 +1,346 @@
+// render_farm.cpp
+// Batch renderer: renders every variation in a manifest as its own
+// ambient::Machine (the firmware's engine plus main-loop control code, machine.h)
+// on a work-stealing thread pool, and streams each to its WAV file through a
+// large write buffer. Instances share nothing mutable: each has its own machine
+// and delay memory; the sample bed and wavetables are read-only once loaded.
+//
+//   render_farm MANIFEST [--jobs N] [--rate 48000] [--block 48]
+//               [--format pcm16|float32] [--sample BED.bin] [--out-dir DIR]
+//
+// The manifest lists one variation per line as space-separated key=value fields;
+// blank lines and lines starting with # are skipped.
+//
+//   out=FILE.wav        output file, relative to --out-dir (required)
+//   minutes=M           length (default 1)
+//   bpm=B               tempo within the pot range 30-120 (default 50)
+//   root=K              starting circle-of-fifths position 0-11 (default 0 = C)
+//   cycle=N             start N cycles into the sequence (default 0; constant-time seek)
+//   nudges=T1,T2,...    root-button presses, in seconds from the start
+//
+// cycle=N is usable up to about 3000, counting the cycles the variation renders
+// (240 / bpm seconds each). Past that the followers leave the MIDI range, and
+// from 4561 the output clips (see render_cli.cpp and deep_start_check).
+//
+// Like the Seed's main loop, every block is followed by one control pass: the BPM
+// pot (held where `bpm` puts it) is read and the next cycle prepared; button
+// presses land on the first pass at or after their time. A variation renders the
+// same whatever --jobs is, and with no nudges matches `render --bpm B`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ambient_engine.h"
+#include "machine.h"
+#include "sample_data.h"
+#include "wav_writer.h"
+#include "work_stealing_pool.h"
+#if defined(AMBIENT_OSC_WAVETABLE)
+#include "wavetable.h"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// Bytes of stdio buffer per output file: about 2.7 s of 48 kHz float stereo.
+static const size_t kWriteBuffer = 1 << 20;
+
+struct Variation {
+    std::string        out;
+    float              minutes;
+    float              bpm;
+    int                root;
+    uint32_t           cycle;
+    std::vector<float> nudges; // seconds, ascending
+};
+
+struct Settings {
+    float                   sample_rate;
+    size_t                  block;
+    host::WavWriter::Format format;
+    std::string             out_dir;
+};
+
+struct Result {
+    bool   ok;
+    double wall_sec;
+    int    worker;
+};
+
+static void PrintUsage() {
+    fprintf(stderr,
+            "usage: render_farm MANIFEST [--jobs N] [--rate HZ] [--block FRAMES]\n"
+            "                   [--format pcm16|float32] [--sample BED.bin] [--out-dir DIR]\n"
+            "manifest lines: out=FILE.wav [minutes=M] [bpm=B] [root=K] [cycle=N] [nudges=T1,T2,...]\n");
+}
+
+// Fills `v` from one manifest line. Returns false (after printing why) on a bad field.
+static bool ParseVariation(char* line, int line_number, const char* path, Variation& v) {
+    v.out.clear();
+    v.minutes = 1.0f;
+    v.bpm     = 50.0f;
+    v.root    = 0;
+    v.cycle   = 0;
+    v.nudges.clear();
+
+    char* save = nullptr;
+    for(char* field = strtok_r(line, " \t\r\n", &save); field != nullptr; field = strtok_r(nullptr, " \t\r\n", &save)) {
+        char* value = strchr(field, '=');
+        if(value == nullptr) {
+            fprintf(stderr, "%s:%d: expected key=value, got '%s'\n", path, line_number, field);
+            return false;
+        }
+        *value++ = '\0';
+        if(strcmp(field, "out") == 0) {
+            v.out = value;
+        } else if(strcmp(field, "minutes") == 0) {
+            v.minutes = static_cast<float>(atof(value));
+        } else if(strcmp(field, "bpm") == 0) {
+            v.bpm = static_cast<float>(atof(value));
+        } else if(strcmp(field, "root") == 0) {
+            v.root = atoi(value);
+        } else if(strcmp(field, "cycle") == 0) {
+            v.cycle = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if(strcmp(field, "nudges") == 0) {
+            char* at = nullptr;
+            for(char* t = strtok_r(value, ",", &at); t != nullptr; t = strtok_r(nullptr, ",", &at)) {
+                v.nudges.push_back(static_cast<float>(atof(t)));
+            }
+            std::sort(v.nudges.begin(), v.nudges.end());
+        } else {
+            fprintf(stderr, "%s:%d: unknown field '%s'\n", path, line_number, field);
+            return false;
+        }
+    }
+
+    if(v.out.empty() || v.minutes <= 0.0f || v.bpm < ambient::Machine::kMinBpm || v.bpm > ambient::Machine::kMaxBpm
+       || v.root < 0 || v.root > 11) {
+        fprintf(stderr, "%s:%d: need out=, minutes > 0, bpm 30-120 and root 0-11\n", path, line_number);
+        return false;
+    }
+    return true;
+}
+
+static bool ReadManifest(const char* path, std::vector<Variation>& variations) {
+    FILE* f = fopen(path, "r");
+    if(f == nullptr) {
+        fprintf(stderr, "render_farm: cannot open %s\n", path);
+        return false;
+    }
+    char line[4096];
+    int  line_number = 0;
+    bool ok          = true;
+    while(ok && fgets(line, sizeof(line), f) != nullptr) {
+        line_number++;
+        const char* start = line + strspn(line, " \t");
+        if(*start == '#' || *start == '\n' || *start == '\r' || *start == '\0') {
+            continue;
+        }
+        Variation v;
+        ok = ParseVariation(line, line_number, path, v);
+        if(ok) {
+            variations.push_back(v);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+// The engine's buffers are cache-line aligned, which plain `new` does not honour
+// before C++17, and both objects are too large for a worker's stack.
+template <typename T>
+struct AlignedDelete {
+    void operator()(T* p) const {
+        p->~T();
+        free(p);
+    }
+};
+
+template <typename T>
+static std::unique_ptr<T, AlignedDelete<T>> MakeAligned() {
+    const size_t size = (sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T);
+    void* const  mem  = aligned_alloc(alignof(T), size);
+    return std::unique_ptr<T, AlignedDelete<T>>(mem != nullptr ? new(mem) T : nullptr);
+}
+
+// Renders one variation start to finish on the calling thread.
+static bool RenderVariation(const Variation& v, const Settings& s) {
+    const std::string path = s.out_dir.empty() ? v.out : s.out_dir + "/" + v.out;
+
+    const uint64_t total_frames = static_cast<uint64_t>(v.minutes * 60.0f * s.sample_rate);
+    if(total_frames > host::WavWriter::MaxFrames(2, s.format)) {
+        fprintf(stderr, "render_farm: %s is past the 4 GiB WAV limit\n", path.c_str());
+        return false;
+    }
+
+    host::WavWriter wav;
+    if(!wav.Open(path.c_str(), static_cast<uint32_t>(s.sample_rate), 2, s.format, kWriteBuffer)) {
+        fprintf(stderr, "render_farm: cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    auto delay   = MakeAligned<ambient::DelayBuffer>();
+    auto machine = MakeAligned<ambient::Machine>();
+    if(!delay || !machine) {
+        fprintf(stderr, "render_farm: out of memory for %s\n", path.c_str());
+        return false;
+    }
+    machine->Init(s.sample_rate, delay.get(), v.bpm, v.root, v.cycle);
+
+    const float        pot = ambient::Machine::PotForBpm(v.bpm);
+    std::vector<float> buffer(s.block * 2);
+    size_t             next_nudge = 0;
+
+    uint64_t done = 0;
+    while(done < total_frames) {
+        size_t frames = s.block;
+        if(total_frames - done < frames) {
+            frames = static_cast<size_t>(total_frames - done);
+        }
+        machine->Process(buffer.data(), frames * 2);
+        wav.Write(buffer.data(), frames);
+        done += frames;
+
+        // Main-loop pass between callbacks. A press the full queue refused is
+        // retried on the next pass, as a held button would be.
+        const double now = static_cast<double>(done) / s.sample_rate;
+        if(next_nudge < v.nudges.size() && now >= v.nudges[next_nudge] && machine->NudgeRoot()) {
+            next_nudge++;
+        }
+        machine->Poll(pot);
+    }
+
+    if(!wav.Close()) {
+        fprintf(stderr, "render_farm: write to %s failed\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* manifest    = nullptr;
+    int         jobs        = static_cast<int>(std::thread::hardware_concurrency());
+    const char* sample_path = AMBIENT_SAMPLE_BLOB;
+    Settings    settings{48000.0f, 48, host::WavWriter::FORMAT_PCM16, std::string()};
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if(arg[0] != '-' && manifest == nullptr) {
+            manifest = arg;
+            continue;
+        }
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if(next == nullptr) {
+            PrintUsage();
+            return 1;
+        }
+        if(strcmp(arg, "--jobs") == 0) {
+            jobs = atoi(next);
+        } else if(strcmp(arg, "--rate") == 0) {
+            settings.sample_rate = static_cast<float>(atof(next));
+        } else if(strcmp(arg, "--block") == 0) {
+            settings.block = static_cast<size_t>(atoi(next));
+        } else if(strcmp(arg, "--format") == 0) {
+            settings.format = strcmp(next, "float32") == 0 ? host::WavWriter::FORMAT_FLOAT32
+                                                           : host::WavWriter::FORMAT_PCM16;
+        } else if(strcmp(arg, "--sample") == 0) {
+            sample_path = next;
+        } else if(strcmp(arg, "--out-dir") == 0) {
+            settings.out_dir = next;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+        i++;
+    }
+
+    if(manifest == nullptr || settings.block == 0 || settings.block > 4096 || settings.sample_rate <= 0.0f) {
+        PrintUsage();
+        return 1;
+    }
+    if(jobs < 1) {
+        jobs = 1;
+    }
+
+    std::vector<Variation> variations;
+    if(!ReadManifest(manifest, variations)) {
+        return 1;
+    }
+    if(variations.empty()) {
+        fprintf(stderr, "render_farm: %s lists no variations\n", manifest);
+        return 1;
+    }
+
+    // Shared read-only data is loaded once, before any worker starts.
+    if(!MapSampleData(sample_path)) {
+        fprintf(stderr, "render_farm: cannot load sample blob %s\n", sample_path);
+        return 1;
+    }
+#if defined(AMBIENT_OSC_WAVETABLE)
+    ambient::SharedWavetables().Init();
+#endif
+
+    // Longest first, so the pool's tail is made of short renders.
+    std::vector<size_t> order(variations.size());
+    for(size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&variations](size_t a, size_t b) {
+        return variations[a].minutes > variations[b].minutes;
+    });
+
+    if(static_cast<size_t>(jobs) > variations.size()) {
+        jobs = static_cast<int>(variations.size());
+    }
+    host::WorkStealingPool pool(jobs);
+    std::vector<Result>    results(variations.size());
+
+    const auto start = Clock::now();
+    pool.Run(order, [&](int worker, size_t index) {
+        const auto job_start = Clock::now();
+        results[index].ok       = RenderVariation(variations[index], settings);
+        results[index].wall_sec = std::chrono::duration<double>(Clock::now() - job_start).count();
+        results[index].worker   = worker;
+        const double audio_sec  = variations[index].minutes * 60.0;
+        printf("[%d] %s: %.1f s of audio in %.2f s (%.1fx realtime)%s\n",
+               worker,
+               variations[index].out.c_str(),
+               audio_sec,
+               results[index].wall_sec,
+               results[index].wall_sec > 0.0 ? audio_sec / results[index].wall_sec : 0.0,
+               results[index].ok ? "" : " FAILED");
+    });
+    const double wall_sec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    double audio_sec = 0.0;
+    double busy_sec  = 0.0;
+    int    failed    = 0;
+    for(size_t i = 0; i < variations.size(); i++) {
+        audio_sec += variations[i].minutes * 60.0;
+        busy_sec += results[i].wall_sec;
+        failed += results[i].ok ? 0 : 1;
+    }
+
+    printf("rendered %zu variations, %.1f s of audio in %.2f s on %d threads (%.1fx realtime, %.2f renders in parallel on average)\n",
+           variations.size(),
+           audio_sec,
+           wall_sec,
+           jobs,
+           wall_sec > 0.0 ? audio_sec / wall_sec : 0.0,
+           wall_sec > 0.0 ? busy_sec / wall_sec : 0.0);
+    for(int w = 0; w < pool.Workers(); w++) {
+        printf("  worker %d: %zu renders, %zu stolen\n", w, pool.Stats(w).ran, pool.Stats(w).stolen);
+    }
+    if(failed > 0) {
+        fprintf(stderr, "render_farm: %d of %zu variations failed\n", failed, variations.size());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+// sample_data_mmap.cpp
+// Host side of sample_data.h: the blob is mapped from disk at run time, so a new
+// bed only needs tools/convert_sample.py, not a rebuild.
+
+#include "sample_data.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ambient::SampleView sample_data;
+
+bool LoadLinkedSampleData() {
+    return false;
+}
+
+bool MapSampleData(const char* path) {
+    const int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* const blob = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(blob == MAP_FAILED) {
+        return false;
+    }
+
+    if(!ambient::ParseSampleBlob(static_cast<const uint8_t*>(blob), static_cast<size_t>(st.st_size), sample_data)) {
+        munmap(blob, static_cast<size_t>(st.st_size));
+        return false;
+    }
+    return true;
+}
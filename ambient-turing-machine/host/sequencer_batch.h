@@ -0,0 +1,367 @@
+// sequencer_batch.h
+// Sequencer Batch — Many Sequencers in SIMD Lanes
+// Runs kLanes independent copies of turing::sequencer_tick side by side, one per
+// vector lane, for sweeps over variants of the sequencer's rules. Every rule
+// constant (gate periods and lengths, follower deltas, octave clamps) is per-lane
+// data in SequencerRules; SequencerRules::Default() is the rule set in
+// turing_sequencer.h, and with it every lane matches the scalar tick note for
+// note (host/build/sequencer_batch_check).
+//
+// The kernel has no division: the `cycle % period` terms are per-lane phase
+// counters, the root steps round the circle of fifths by adding 7 mod 12, and a
+// follower degree is kept as octave + scale step (floor division by 7 done once,
+// at Init), so each rule is a handful of compares and selects on GCC vector
+// types: 8 lanes with AVX2 (make OPT="-O2 -mavx2"), otherwise 4 (SSE2, NEON).
+//
+// Limits of the batch form: follower deltas must lie in -7..7 (one carry per
+// update), the V5 walk may be at most 7 steps long, nudges are not modelled after
+// Init, and the phase counters do not follow the 32-bit cycle counter's wrap.
+
+#ifndef HOST_SEQUENCER_BATCH_H
+#define HOST_SEQUENCER_BATCH_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "turing_sequencer.h"
+
+namespace host {
+
+// One lane's rules. Voices are numbered 1-6 as in turing_sequencer.h.
+struct SequencerRules {
+    // Voice n gates when (cycle % period) < on; V2 also needs V5 on last cycle,
+    // V4 a V2 trigger within the last `v4_window` cycles.
+    int32_t period[6];
+    int32_t on[6];
+    int32_t v4_window;
+
+    int32_t walk_hold;   // V5 holds each scale step this many cycles
+    int32_t walk_length; // and walks steps 0..walk_length-1 (at most 7)
+    int32_t root_hold;   // cycles per circle-of-fifths step
+
+    // Follower degree changes (each -7..7).
+    int32_t v2_up;      // V5 stepped up
+    int32_t v2_down;    // V5 stepped down
+    int32_t v4_both;    // V3 and V2 were on
+    int32_t v4_third;   // V3 on, V2 off
+    int32_t v4_mirror;  // V3 off, V2 on
+    int32_t v4_neither; // both off
+
+    // Octave clamps: lowest octave (-1 for none) and, for V5 and V6, the MIDI
+    // note at and above which the voice drops an octave.
+    int32_t min_octave[6];
+    int32_t v5_ceiling;
+    int32_t v6_ceiling;
+
+    static SequencerRules Default() {
+        const SequencerRules r = {
+            {12, 3, 7, 5, 5, 4}, // period
+            {10, 1, 5, 1, 4, 1}, // on
+            2,
+            3,
+            7,
+            12,
+            -1,
+            1,
+            1,
+            -2,
+            0,
+            3,
+            {-1, 4, -1, 4, 3, 4}, // min_octave
+            72,
+            84,
+        };
+        return r;
+    }
+};
+
+// One lane's output for one cycle.
+// Stored little-endian as written, 8 bytes.
+struct SequencerEvent {
+    uint8_t gates;    // bit n-1 set when voice n is gated this cycle
+    uint8_t root;     // chromatic root 0-11
+    uint8_t notes[6]; // MIDI note of each voice; 255 for notes at or above 255,
+                      // which the Wanderer and Echo reach in long runs
+};
+
+class SequencerBatch {
+  public:
+#if defined(__AVX2__)
+    static const int kLanes = 8; // one AVX2 register
+#else
+    static const int kLanes = 4; // one SSE2 / NEON register
+#endif
+
+    SequencerBatch() {}
+    ~SequencerBatch() {}
+
+    // Lane l runs rules[l] from starts[l], any state the scalar sequencer can
+    // reach (after sequencer_init, nudges or sequencer_seek).
+    void Init(const SequencerRules rules[kLanes], const turing::SequencerState starts[kLanes]) {
+        for(int l = 0; l < kLanes; l++) {
+            const SequencerRules&          r = rules[l];
+            const turing::SequencerState& s = starts[l];
+            const uint32_t                 c = s.cycle;
+
+            for(int v = 0; v < 6; v++) {
+                period_[v][l]   = r.period[v];
+                on_[v][l]       = r.on[v];
+                phase_[v][l]    = static_cast<int32_t>(c % static_cast<uint32_t>(r.period[v]));
+                gate_[v][l]     = s.voices[v].gate ? -1 : 0;
+                min_midi_[v][l] = r.min_octave[v] >= 0 ? r.min_octave[v] * 12 : kNoClamp;
+            }
+            v4_window_[l]  = r.v4_window;
+            v5_ceiling_[l] = r.v5_ceiling;
+            v6_ceiling_[l] = r.v6_ceiling;
+            v2_up_[l]      = r.v2_up;
+            v2_down_[l]    = r.v2_down;
+            v4_delta_[0][l] = r.v4_neither;
+            v4_delta_[1][l] = r.v4_mirror;
+            v4_delta_[2][l] = r.v4_third;
+            v4_delta_[3][l] = r.v4_both;
+
+            walk_hold_[l]   = r.walk_hold;
+            walk_length_[l] = r.walk_length;
+            walk_phase_[l]  = static_cast<int32_t>(c % static_cast<uint32_t>(r.walk_hold));
+            walk_step_[l]   = static_cast<int32_t>(c / static_cast<uint32_t>(r.walk_hold) % static_cast<uint32_t>(r.walk_length));
+            v5_prev_[l]     = s.v5_history[0];
+
+            root_hold_[l]  = r.root_hold;
+            root_phase_[l] = static_cast<int32_t>(c % static_cast<uint32_t>(r.root_hold));
+            root_[l]       = static_cast<int32_t>(c / static_cast<uint32_t>(r.root_hold) % 12 * 7 % 12);
+
+            const int64_t since = static_cast<int64_t>(static_cast<int32_t>(c)) - s.last_v2_trigger_cycle;
+            since_v2_[l]        = since > kSinceMax ? kSinceMax : static_cast<int32_t>(since);
+
+            Split(s.frozen_v2_degree, v2_oct_[l], v2_step_[l]);
+            Split(s.frozen_v4_degree, v4_oct_[l], v4_step_[l]);
+            Split(s.frozen_v6_degree, v6_oct_[l], v6_step_[l]);
+            for(int v = 0; v < 6; v++) {
+                midi_[v][l] = s.voices[v].midi_note;
+            }
+            cycle_[l] = c;
+        }
+    }
+
+    // Advances every lane `cycles` cycles. out[l], when not null, receives lane l's
+    // events, one per cycle.
+    void Run(uint32_t cycles, SequencerEvent* const out[kLanes]);
+
+    // Lane l's next cycle and its frozen follower degrees (V2, V4, V6), as the
+    // scalar state's cycle and frozen_v*_degree fields would read.
+    uint32_t Cycle(int lane) const { return cycle_[lane]; }
+    void     Degrees(int lane, int degrees[3]) const {
+        degrees[0] = v2_oct_[lane] * 7 + v2_step_[lane];
+        degrees[1] = v4_oct_[lane] * 7 + v4_step_[lane];
+        degrees[2] = v6_oct_[lane] * 7 + v6_step_[lane];
+    }
+
+  private:
+    typedef int32_t V __attribute__((vector_size(4 * kLanes)));
+
+    static const int32_t kNoClamp  = -(1 << 30);
+    static const int32_t kSinceMax = 1 << 30;
+
+    static void Split(int degree, int32_t& oct, int32_t& step) {
+        oct  = degree >= 0 ? degree / 7 : (degree - 6) / 7;
+        step = degree - oct * 7;
+    }
+
+    static V Load(const int32_t* p) {
+        V v;
+        memcpy(&v, p, sizeof(V));
+        return v;
+    }
+
+    static void Store(int32_t* p, V v) { memcpy(p, &v, sizeof(V)); }
+
+    // Masks are -1 (true) or 0, as vector compares produce.
+    static V Select(V mask, V a, V b) { return (mask & a) | (~mask & b); }
+
+    // Counts a phase up by one, wrapping at `period`.
+    static V Step(V phase, V period) {
+        phase += 1;
+        return phase & ~(phase == period);
+    }
+
+    // Adds a delta in -7..7 to a degree kept as octave + step 0..6.
+    static void AddDegree(V& oct, V& step, V delta) {
+        step += delta;
+        const V over  = step > 6;
+        const V under = step < 0;
+        step += (over & -7) | (under & 7);
+        oct += -over + under;
+    }
+
+    // turing::degree_to_midi with the clamp worked out from the note's pitch
+    // class: root + MAJOR_SCALE[step] is 0..22, and min_midi is a whole octave (C).
+    static V Midi(V root, V octave, V step, V min_midi) {
+        const V x     = root + step * 2 + (step > 2);
+        const V pitch = x + ((x > 11) & -12);
+        const V midi  = octave * 12 + x;
+        return Select(midi < min_midi, min_midi + pitch, midi);
+    }
+
+    // Rules.
+    alignas(32) int32_t period_[6][kLanes];
+    alignas(32) int32_t on_[6][kLanes];
+    alignas(32) int32_t min_midi_[6][kLanes];
+    alignas(32) int32_t v4_window_[kLanes];
+    alignas(32) int32_t v5_ceiling_[kLanes];
+    alignas(32) int32_t v6_ceiling_[kLanes];
+    alignas(32) int32_t v2_up_[kLanes];
+    alignas(32) int32_t v2_down_[kLanes];
+    alignas(32) int32_t v4_delta_[4][kLanes]; // by (V3 was on) * 2 + (V2 was on)
+    alignas(32) int32_t walk_hold_[kLanes];
+    alignas(32) int32_t walk_length_[kLanes];
+    alignas(32) int32_t root_hold_[kLanes];
+
+    // State.
+    alignas(32) int32_t phase_[6][kLanes];
+    alignas(32) int32_t gate_[6][kLanes];
+    alignas(32) int32_t walk_phase_[kLanes];
+    alignas(32) int32_t walk_step_[kLanes];
+    alignas(32) int32_t v5_prev_[kLanes];
+    alignas(32) int32_t root_phase_[kLanes];
+    alignas(32) int32_t root_[kLanes];
+    alignas(32) int32_t since_v2_[kLanes]; // cycles since V2 last triggered
+    alignas(32) int32_t v2_oct_[kLanes];
+    alignas(32) int32_t v2_step_[kLanes];
+    alignas(32) int32_t v4_oct_[kLanes];
+    alignas(32) int32_t v4_step_[kLanes];
+    alignas(32) int32_t v6_oct_[kLanes];
+    alignas(32) int32_t v6_step_[kLanes];
+    alignas(32) int32_t midi_[6][kLanes]; // notes of the last cycle run
+    uint32_t cycle_[kLanes];
+};
+
+inline void SequencerBatch::Run(uint32_t cycles, SequencerEvent* const out[kLanes]) {
+    V period[6], on[6], min_midi[6], phase[6], gate[6], midi[6];
+    for(int v = 0; v < 6; v++) {
+        period[v]   = Load(period_[v]);
+        on[v]       = Load(on_[v]);
+        min_midi[v] = Load(min_midi_[v]);
+        phase[v]    = Load(phase_[v]);
+        gate[v]     = Load(gate_[v]);
+        midi[v]     = Load(midi_[v]);
+    }
+    const V v4_window   = Load(v4_window_);
+    const V v5_ceiling  = Load(v5_ceiling_);
+    const V v6_ceiling  = Load(v6_ceiling_);
+    const V v2_up       = Load(v2_up_);
+    const V v2_down     = Load(v2_down_);
+    const V v4_neither  = Load(v4_delta_[0]);
+    const V v4_mirror   = Load(v4_delta_[1]);
+    const V v4_third    = Load(v4_delta_[2]);
+    const V v4_both     = Load(v4_delta_[3]);
+    const V walk_hold   = Load(walk_hold_);
+    const V walk_length = Load(walk_length_);
+    const V root_hold   = Load(root_hold_);
+
+    V walk_phase = Load(walk_phase_);
+    V walk_step  = Load(walk_step_);
+    V v5_prev    = Load(v5_prev_);
+    V root_phase = Load(root_phase_);
+    V root       = Load(root_);
+    V since_v2   = Load(since_v2_);
+    V v2_oct     = Load(v2_oct_);
+    V v2_step    = Load(v2_step_);
+    V v4_oct     = Load(v4_oct_);
+    V v4_step    = Load(v4_step_);
+    V v6_oct     = Load(v6_oct_);
+    V v6_step    = Load(v6_step_);
+
+    const V zero = V{};
+    for(uint32_t c = 0; c < cycles; c++) {
+        const V prev[6] = {gate[0], gate[1], gate[2], gate[3], gate[4], gate[5]};
+
+        // Gates, in sequencer_tick's order: V2's trigger resets the window V4 reads.
+        gate[0]  = phase[0] < on[0];
+        gate[2]  = phase[2] < on[2];
+        gate[4]  = phase[4] < on[4];
+        gate[1]  = (phase[1] < on[1]) & prev[4];
+        since_v2 = since_v2 & ~gate[1];
+        gate[3]  = (phase[3] < on[3]) & (since_v2 <= v4_window);
+        gate[5]  = phase[5] < on[5];
+
+        // Drones and the walker.
+        midi[0]    = Midi(root, zero + 3, zero, min_midi[0]);
+        midi[2]    = Midi(root, zero + 3, zero + 2, min_midi[2]);
+        midi[4]    = Midi(root, Select(gate[2], zero + 4, zero + 3), walk_step, min_midi[4]);
+        midi[4]   -= (midi[4] >= v5_ceiling) & 12;
+        const V up   = walk_step > v5_prev;
+        const V down = walk_step < v5_prev;
+        v5_prev      = walk_step;
+
+        // Followers.
+        AddDegree(v2_oct, v2_step, gate[1] & ((up & v2_up) | (down & v2_down)));
+        midi[1] = Midi(root, v2_oct + 3, v2_step, min_midi[1]);
+
+        const V echo_oct  = v4_oct;
+        const V echo_step = v4_step;
+        const V v4_delta  = Select(prev[2], Select(prev[1], v4_both, v4_third), Select(prev[1], v4_mirror, v4_neither));
+        AddDegree(v4_oct, v4_step, gate[3] & v4_delta);
+        midi[3] = Midi(root, v4_oct + 3, v4_step, min_midi[3]);
+
+        v6_oct  = Select(gate[5], echo_oct, v6_oct);
+        v6_step = Select(gate[5], echo_step, v6_step);
+        midi[5] = Midi(root, v6_oct + Select(prev[0], zero + 4, zero + 5), v6_step, min_midi[5]);
+        midi[5] -= (midi[5] >= v6_ceiling) & 12;
+
+        if(out != nullptr) {
+            // Each event packed as two little-endian words in the lanes, then
+            // scattered to the lanes' streams.
+            const V bits = (gate[0] & 1) | (gate[1] & 2) | (gate[2] & 4) | (gate[3] & 8) | (gate[4] & 16) | (gate[5] & 32);
+            V       note[6];
+            for(int v = 0; v < 6; v++) {
+                note[v] = Select(midi[v] > 255, V{} + 255, midi[v]);
+            }
+            const V lo = bits | (root << 8) | (note[0] << 16) | (note[1] << 24);
+            const V hi = note[2] | (note[3] << 8) | (note[4] << 16) | (note[5] << 24);
+            for(int l = 0; l < kLanes; l++) {
+                if(out[l] != nullptr) {
+                    const uint32_t words[2] = {static_cast<uint32_t>(lo[l]), static_cast<uint32_t>(hi[l])};
+                    memcpy(&out[l][c], words, sizeof(words));
+                }
+            }
+        }
+
+        // Next cycle's counters.
+        for(int v = 0; v < 6; v++) {
+            phase[v] = Step(phase[v], period[v]);
+        }
+        walk_phase       = Step(walk_phase, walk_hold);
+        const V walk_on  = walk_phase == zero;
+        walk_step        = Select(walk_on, Step(walk_step, walk_length), walk_step);
+        root_phase       = Step(root_phase, root_hold);
+        const V root_on  = root_phase == zero;
+        root            += root_on & 7;
+        root            += (root > 11) & -12;
+        since_v2        -= since_v2 < kSinceMax;
+    }
+
+    for(int v = 0; v < 6; v++) {
+        Store(phase_[v], phase[v]);
+        Store(gate_[v], gate[v]);
+        Store(midi_[v], midi[v]);
+    }
+    Store(walk_phase_, walk_phase);
+    Store(walk_step_, walk_step);
+    Store(v5_prev_, v5_prev);
+    Store(root_phase_, root_phase);
+    Store(root_, root);
+    Store(since_v2_, since_v2);
+    Store(v2_oct_, v2_oct);
+    Store(v2_step_, v2_step);
+    Store(v4_oct_, v4_oct);
+    Store(v4_step_, v4_step);
+    Store(v6_oct_, v6_oct);
+    Store(v6_step_, v6_step);
+    for(int l = 0; l < kLanes; l++) {
+        cycle_[l] += cycles;
+    }
+}
+
+} // namespace host
+
+#endif // HOST_SEQUENCER_BATCH_H
@@ -0,0 +1,86 @@
+// sequencer_lookahead_check.cpp
+// Checks that a root nudge lands on the next cycle boundary whenever it arrives
+// relative to SequencerLookahead::Prepare():
+//   - before Prepare (the spare is computed with it);
+//   - inside Prepare, after the request was read but before the spare is published;
+//   - after Prepare (the ready spare is taken back);
+//   - with no Prepare at all (the audio thread ticks inline).
+// Each run is compared, cycle by cycle, with sequencer_tick and sequencer_nudge_root
+// applied directly. Exits non-zero on any mismatch.
+//
+//   sequencer_lookahead_check
+
+#include <cstdio>
+
+#include "sequencer_lookahead.h"
+#include "sequencer_state_check.h"
+
+enum When { NONE, BEFORE_PREPARE, INSIDE_PREPARE, AFTER_PREPARE, NO_PREPARE };
+
+static const char* const kWhenNames[] = {"no nudge", "before Prepare", "inside Prepare", "after Prepare", "without Prepare"};
+
+static const int kCycles = 400;
+
+// Cycles at which a press arrives (the nudge takes effect on the boundary after).
+static bool PressAt(int cycle) {
+    return cycle % 7 == 3 || cycle % 31 == 0;
+}
+
+// Runs kCycles boundaries with presses delivered at `when`. Returns the first cycle
+// whose live state differs from the reference, or -1.
+static int Run(When when) {
+    static ambient::SequencerLookahead lookahead;
+    lookahead.Init();
+
+    turing::SequencerState reference = {};
+    turing::sequencer_init(reference);
+
+    for(int cycle = 0; cycle < kCycles; cycle++) {
+        const bool press = when != NONE && PressAt(cycle);
+        if(press && when == BEFORE_PREPARE) {
+            lookahead.RequestNudge();
+        }
+        if(when == INSIDE_PREPARE) {
+            lookahead.Prepare([&] {
+                if(press) {
+                    lookahead.RequestNudge();
+                }
+            });
+        } else if(when != NO_PREPARE) {
+            lookahead.Prepare();
+        }
+        if(press && (when == AFTER_PREPARE || when == NO_PREPARE)) {
+            lookahead.RequestNudge();
+        }
+
+        lookahead.Advance();
+        if(press) {
+            turing::sequencer_nudge_root(reference);
+        }
+        turing::sequencer_tick(reference);
+
+        if(!SameState(lookahead.Live(), reference)) {
+            return cycle;
+        }
+    }
+    return -1;
+}
+
+int main() {
+    int bad = 0;
+    for(int when = NONE; when <= NO_PREPARE; when++) {
+        const int first = Run(static_cast<When>(when));
+        if(first < 0) {
+            printf("nudge %-16s ok\n", kWhenNames[when]);
+        } else {
+            printf("nudge %-16s FAIL at cycle %d\n", kWhenNames[when], first);
+            bad++;
+        }
+    }
+
+    if(bad > 0) {
+        printf("FAIL: %d runs\n", bad);
+        return 1;
+    }
+    return 0;
+}
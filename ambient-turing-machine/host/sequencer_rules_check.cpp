@@ -0,0 +1,151 @@
+// sequencer_rules_check.cpp
+// Checks the compiled rule machines in sequencer_rules.h:
+//   - turing::DefaultRules::Tick against the reference sequencer_tick, every
+//     field of the state after every tick, from fresh, nudged and seeked starts
+//     with root nudges along the way;
+//   - a machine with changed constants against host::SequencerBatch running the
+//     same rules, note for note.
+// Then times both ticks. Exits non-zero on any mismatch.
+//
+//   sequencer_rules_check [cycles]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "sequencer_batch.h"
+#include "sequencer_rules.h"
+#include "sequencer_state_check.h"
+
+using Clock = std::chrono::steady_clock;
+using turing::SequencerState;
+
+// Ticks both from `start` for `cycles`, nudging both now and then. Returns false
+// at the first difference.
+static bool CheckDefault(const SequencerState& start, uint32_t cycles) {
+    SequencerState ref      = start;
+    SequencerState compiled = start;
+    for(uint32_t c = 0; c < cycles; c++) {
+        if(rand() % 5000 == 0) {
+            turing::sequencer_nudge_root(ref);
+            turing::sequencer_nudge_root(compiled);
+        }
+        turing::sequencer_tick(ref);
+        turing::DefaultRules::Tick(compiled);
+        if(!SameState(ref, compiled)) {
+            printf("  mismatch at cycle %u\n", ref.cycle - 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Changed constants, within what SequencerRules can express: Mirror deltas,
+// Wanderer deltas and lowest octave, V4 window, walk speed, Echo period and
+// ceiling, root hold.
+typedef turing::Machine<turing::VoiceRule<turing::Every<12, 10>, turing::Fixed<0, 3>>,
+                        turing::VoiceRule<turing::EveryIfWasOn<3, 4>, turing::Mirror<2, -1, 3, 4>>,
+                        turing::VoiceRule<turing::Every<7, 5>, turing::Fixed<2, 3>>,
+                        turing::VoiceRule<turing::EveryAfterTrigger<5, 4>, turing::Wanderer<2, 1, -1, 3, 1, -2, 3, 3>>,
+                        turing::VoiceRule<turing::Every<5, 4>, turing::Walk<2, 7, 2, 4, 3, 3, 72>>,
+                        turing::VoiceRule<turing::Every<6>, turing::Echo<3, 0, 4, 5, 4, 90>>,
+                        9>
+    VariantRules;
+
+static host::SequencerRules VariantBatchRules() {
+    host::SequencerRules r = host::SequencerRules::Default();
+    r.v2_up         = 2;
+    r.v2_down       = -1;
+    r.v4_window     = 4;
+    r.v4_both       = -1;
+    r.v4_third      = 3;
+    r.v4_mirror     = 1;
+    r.v4_neither    = -2;
+    r.min_octave[3] = 3;
+    r.walk_hold     = 2;
+    r.period[5]     = 6;
+    r.v6_ceiling    = 90;
+    r.root_hold     = 9;
+    return r;
+}
+
+static bool CheckVariant(uint32_t cycles) {
+    const int            lanes = host::SequencerBatch::kLanes;
+    host::SequencerRules rules[host::SequencerBatch::kLanes];
+    SequencerState       starts[host::SequencerBatch::kLanes];
+    SequencerState       compiled[host::SequencerBatch::kLanes];
+    for(int l = 0; l < lanes; l++) {
+        rules[l]    = VariantBatchRules();
+        starts[l]   = Start(l, 0);
+        compiled[l] = starts[l];
+    }
+
+    host::SequencerBatch batch;
+    batch.Init(rules, starts);
+    std::vector<host::SequencerEvent> events(static_cast<size_t>(lanes) * cycles);
+    host::SequencerEvent*             out[host::SequencerBatch::kLanes];
+    for(int l = 0; l < lanes; l++) {
+        out[l] = events.data() + static_cast<size_t>(l) * cycles;
+    }
+    batch.Run(cycles, out);
+
+    for(int l = 0; l < lanes; l++) {
+        for(uint32_t c = 0; c < cycles; c++) {
+            VariantRules::Tick(compiled[l]);
+            const host::SequencerEvent& e    = out[l][c];
+            bool                        same = e.root == compiled[l].root_chromatic;
+            for(int v = 0; v < 6; v++) {
+                const int note = compiled[l].voices[v].midi_note > 255 ? 255 : compiled[l].voices[v].midi_note;
+                same = same && ((e.gates >> v) & 1) == (compiled[l].voices[v].gate ? 1 : 0) && e.notes[v] == note;
+            }
+            if(!same) {
+                printf("  lane %d: mismatch at cycle %u\n", l, compiled[l].cycle - 1);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t cycles = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 1000000;
+    int            bad    = 0;
+
+    srand(7);
+    bool ok = CheckDefault(Start(0, 0), cycles);
+    for(int i = 0; i < 8 && ok; i++) {
+        ok = CheckDefault(Start(rand() % 12, static_cast<uint32_t>(rand())), cycles / 8);
+    }
+    printf("DefaultRules vs sequencer_tick:    %s\n", ok ? "ok" : "FAIL");
+    bad += ok ? 0 : 1;
+
+    ok = CheckVariant(cycles < 200000 ? cycles : 200000);
+    printf("changed rules vs SequencerBatch:   %s\n", ok ? "ok" : "FAIL");
+    bad += ok ? 0 : 1;
+
+    // Tick cost. The states differ so neither loop folds away.
+    SequencerState ref      = Start(0, 0);
+    SequencerState compiled = Start(0, 0);
+    auto           t0       = Clock::now();
+    for(uint32_t c = 0; c < cycles; c++) {
+        turing::sequencer_tick(ref);
+    }
+    const double ref_sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    t0                   = Clock::now();
+    for(uint32_t c = 0; c < cycles; c++) {
+        turing::DefaultRules::Tick(compiled);
+    }
+    const double compiled_sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    printf("tick: reference %.1f ns, compiled %.1f ns (%s)\n",
+           ref_sec / cycles * 1e9,
+           compiled_sec / cycles * 1e9,
+           SameState(ref, compiled) ? "same state" : "DIFFERENT STATE");
+    bad += SameState(ref, compiled) ? 0 : 1;
+
+    if(bad > 0) {
+        printf("FAIL\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+// sequencer_seek_check.cpp
+// Checks turing::sequencer_seek against replaying every tick.
+//   - every target cycle up to 20 000 from the initial state;
+//   - random targets up to 2^24 from the initial state and from nudged states
+//     (a single replay walks past them in order);
+//   - seeks that start from a state the replay reached part way.
+// Then times a seek to the far end of the 32-bit cycle counter.
+// Exits non-zero on any mismatch.
+//
+//   sequencer_seek_check
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "sequencer_state_check.h"
+
+using turing::SequencerState;
+
+// Replays from Start(nudges) and checks a seek from the same start at each target
+// (ascending). Returns the number of mismatches.
+static int CheckTargets(int nudges, const std::vector<uint32_t>& targets) {
+    SequencerState replay = Start(nudges);
+    int            bad    = 0;
+    for(uint32_t target : targets) {
+        while(replay.cycle < target) {
+            turing::sequencer_tick(replay);
+        }
+        if(replay.cycle != target) {
+            continue; // behind the nudged start
+        }
+        SequencerState seek = Start(nudges);
+        turing::sequencer_seek(seek, target);
+        if(!SameState(seek, replay)) {
+            if(bad < 5) {
+                printf("  mismatch: nudges %d, cycle %u\n", nudges, target);
+            }
+            bad++;
+        }
+    }
+    return bad;
+}
+
+int main() {
+    int bad = 0;
+
+    std::vector<uint32_t> dense;
+    for(uint32_t c = 0; c <= 20000; c++) {
+        dense.push_back(c);
+    }
+    int n = CheckTargets(0, dense);
+    printf("every cycle 0-20000 from init:     %s\n", n == 0 ? "ok" : "FAIL");
+    bad += n;
+
+    srand(1234);
+    std::vector<uint32_t> sparse;
+    for(int i = 0; i < 400; i++) {
+        sparse.push_back(static_cast<uint32_t>(((static_cast<uint64_t>(rand()) << 16) ^ static_cast<uint64_t>(rand())) % (1u << 24)));
+    }
+    std::sort(sparse.begin(), sparse.end());
+    for(int nudges = 0; nudges < 12; nudges += 5) {
+        n = CheckTargets(nudges, sparse);
+        printf("400 random cycles < 2^24, %2d nudges: %s\n", nudges, n == 0 ? "ok" : "FAIL");
+        bad += n;
+    }
+
+    // Seeks from part-way states: replay to `from`, seek the copy on to `to`.
+    n = 0;
+    SequencerState replay = Start(0);
+    for(int i = 0; i < 200; i++) {
+        const uint32_t from = replay.cycle + static_cast<uint32_t>(rand() % 5000);
+        const uint32_t to   = from + static_cast<uint32_t>(rand() % 20000);
+        while(replay.cycle < from) {
+            turing::sequencer_tick(replay);
+        }
+        SequencerState seek = replay;
+        turing::sequencer_seek(seek, to);
+        while(replay.cycle < to) {
+            turing::sequencer_tick(replay);
+        }
+        n += SameState(seek, replay) ? 0 : 1;
+    }
+    printf("200 seeks from part-way states:    %s\n", n == 0 ? "ok" : "FAIL");
+    bad += n;
+
+    // Drift per period, and the cost of a seek to the end of the counter.
+    SequencerState s = Start(0);
+    const auto     t0    = std::chrono::steady_clock::now();
+    const uint32_t ticks = turing::sequencer_seek(s, 0xFFFFFFF0u);
+    const auto     t1    = std::chrono::steady_clock::now();
+    printf("seek to cycle %u: %u ticks, %.1f us (v2 %d, v4 %d, v6 %d)\n",
+           s.cycle,
+           ticks,
+           std::chrono::duration<double, std::micro>(t1 - t0).count(),
+           s.frozen_v2_degree,
+           s.frozen_v4_degree,
+           s.frozen_v6_degree);
+
+    if(bad > 0) {
+        printf("FAIL: %d mismatches\n", bad);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+// sequencer_state_check.h
+// Helpers shared by the sequencer checks: a field-by-field comparison of
+// turing::SequencerState and the start states the checks tick from. A field added
+// to SequencerState or Voice belongs in SameVoice/SameState, so every check
+// compares it.
+
+#ifndef HOST_SEQUENCER_STATE_CHECK_H
+#define HOST_SEQUENCER_STATE_CHECK_H
+
+#include <cstdint>
+
+#include "turing_sequencer.h"
+
+static inline bool SameVoice(const turing::Voice& a, const turing::Voice& b) {
+    return a.freq == b.freq && a.midi_note == b.midi_note && a.degree == b.degree && a.octave == b.octave
+           && a.gate == b.gate && a.prev_gate == b.prev_gate && a.active == b.active
+           && a.note_index == b.note_index && a.final_octave == b.final_octave;
+}
+
+static inline bool SameState(const turing::SequencerState& a, const turing::SequencerState& b) {
+    for(int i = 0; i < 6; i++) {
+        if(!SameVoice(a.voices[i], b.voices[i])) {
+            return false;
+        }
+    }
+    return a.cycle == b.cycle && a.frozen_v2_degree == b.frozen_v2_degree && a.frozen_v4_degree == b.frozen_v4_degree
+           && a.frozen_v6_degree == b.frozen_v6_degree && a.prev_v4_degree_for_echo == b.prev_v4_degree_for_echo
+           && a.v5_history[0] == b.v5_history[0] && a.v5_history[1] == b.v5_history[1]
+           && a.last_v2_trigger_cycle == b.last_v2_trigger_cycle && a.root_chromatic == b.root_chromatic
+           && a.root_cycle_index == b.root_cycle_index;
+}
+
+// The initial state after `nudges` root nudges, sought to `cycle`.
+static inline turing::SequencerState Start(int nudges, uint32_t cycle = 0) {
+    turing::SequencerState s = {}; // sequencer_init leaves the display fields to the first tick
+    turing::sequencer_init(s);
+    for(int i = 0; i < nudges; i++) {
+        turing::sequencer_nudge_root(s);
+    }
+    turing::sequencer_seek(s, cycle);
+    return s;
+}
+
+#endif // HOST_SEQUENCER_STATE_CHECK_H
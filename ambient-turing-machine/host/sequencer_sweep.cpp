@@ -0,0 +1,381 @@
+// sequencer_sweep.cpp
+// Rule sweeps: runs every variant of the sequencer rules a manifest describes for
+// a fixed number of cycles on host::SequencerBatch (one variant per SIMD lane,
+// groups of lanes on a work-stealing pool) and writes each variant's per-cycle
+// events into one memory-mapped output file.
+//
+//   sequencer_sweep MANIFEST OUT.seq [--cycles N] [--jobs N]
+//
+// Each manifest line is space-separated key=value fields over the defaults of
+// turing_sequencer.h; blank lines and lines starting with # are skipped. A value
+// may be a list (a,b,c) or an inclusive range (a..b), and a line stands for every
+// combination of its values, so `v4_both=-3..3 v4_third=-3..3` is 49 variants.
+//
+//   vN_period, vN_on        voice N gates when cycle % period < on (N = 1-6)
+//   vN_min_octave           lowest octave of voice N, -1 for none
+//   v4_window               cycles after a V2 trigger in which V4 may fire
+//   walk_hold, walk_length  V5 holds each step walk_hold cycles, walks 0..length-1
+//   root_hold               cycles per circle-of-fifths step
+//   v2_up, v2_down          V2 change when V5 stepped up / down
+//   v4_both, v4_third, v4_mirror, v4_neither
+//                           V4 change by which of V3 / V2 was on last cycle
+//   v5_ceiling, v6_ceiling  MIDI note at which V5 / V6 drop an octave
+//   cycle=N                 start N cycles in (sequencer_seek)
+//   root=K                  root-button presses before the start
+//
+// Output file, little-endian:
+//   SweepHeader
+//   SweepVariant[variants]           the rules and start of each variant
+//   (zeros up to data_offset, a page boundary)
+//   SequencerEvent[cycles] per variant, variant after variant
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sequencer_batch.h"
+#include "work_stealing_pool.h"
+
+using Clock = std::chrono::steady_clock;
+using host::SequencerBatch;
+using host::SequencerEvent;
+using host::SequencerRules;
+
+struct SweepHeader {
+    char     magic[8]; // "ATMSWEEP"
+    uint32_t version;  // 1
+    uint32_t event_bytes;
+    uint32_t variant_bytes;
+    uint32_t variants;
+    uint64_t cycles;
+    uint64_t data_offset;
+};
+
+struct SweepVariant {
+    SequencerRules rules;
+    uint32_t       start_cycle;
+    int32_t        nudges;
+};
+
+static const uint32_t kChunk = 4096; // cycles per Run call
+
+// A settable field: an int32 at `offset` in SweepVariant.
+struct Field {
+    std::string name;
+    size_t      offset;
+};
+
+static std::vector<Field> Fields() {
+    std::vector<Field> f;
+    const size_t       rules = offsetof(SweepVariant, rules);
+    for(int v = 0; v < 6; v++) {
+        const std::string voice = "v" + std::to_string(v + 1);
+        f.push_back({voice + "_period", rules + offsetof(SequencerRules, period) + v * sizeof(int32_t)});
+        f.push_back({voice + "_on", rules + offsetof(SequencerRules, on) + v * sizeof(int32_t)});
+        f.push_back({voice + "_min_octave", rules + offsetof(SequencerRules, min_octave) + v * sizeof(int32_t)});
+    }
+    f.push_back({"v4_window", rules + offsetof(SequencerRules, v4_window)});
+    f.push_back({"walk_hold", rules + offsetof(SequencerRules, walk_hold)});
+    f.push_back({"walk_length", rules + offsetof(SequencerRules, walk_length)});
+    f.push_back({"root_hold", rules + offsetof(SequencerRules, root_hold)});
+    f.push_back({"v2_up", rules + offsetof(SequencerRules, v2_up)});
+    f.push_back({"v2_down", rules + offsetof(SequencerRules, v2_down)});
+    f.push_back({"v4_both", rules + offsetof(SequencerRules, v4_both)});
+    f.push_back({"v4_third", rules + offsetof(SequencerRules, v4_third)});
+    f.push_back({"v4_mirror", rules + offsetof(SequencerRules, v4_mirror)});
+    f.push_back({"v4_neither", rules + offsetof(SequencerRules, v4_neither)});
+    f.push_back({"v5_ceiling", rules + offsetof(SequencerRules, v5_ceiling)});
+    f.push_back({"v6_ceiling", rules + offsetof(SequencerRules, v6_ceiling)});
+    f.push_back({"cycle", offsetof(SweepVariant, start_cycle)});
+    f.push_back({"root", offsetof(SweepVariant, nudges)});
+    return f;
+}
+
+static void SetField(SweepVariant& v, size_t offset, int64_t value) {
+    const int32_t x = static_cast<int32_t>(value);
+    memcpy(reinterpret_cast<char*>(&v) + offset, &x, sizeof(x));
+}
+
+// Within what SequencerBatch handles (see sequencer_batch.h).
+static bool Valid(const SweepVariant& v) {
+    const SequencerRules& r = v.rules;
+    for(int i = 0; i < 6; i++) {
+        if(r.period[i] < 1 || r.on[i] < 0 || r.min_octave[i] < -1 || r.min_octave[i] > 9) {
+            return false;
+        }
+    }
+    const int32_t deltas[6] = {r.v2_up, r.v2_down, r.v4_both, r.v4_third, r.v4_mirror, r.v4_neither};
+    for(int32_t d : deltas) {
+        if(d < -7 || d > 7) {
+            return false;
+        }
+    }
+    return r.v4_window >= 0 && r.walk_hold >= 1 && r.walk_length >= 1 && r.walk_length <= 7 && r.root_hold >= 1
+           && v.nudges >= 0 && v.nudges <= 11;
+}
+
+// Appends every variant one manifest line stands for. Returns false (after
+// printing why) on a bad field.
+static bool ExpandLine(char* line, int line_number, const char* path, std::vector<SweepVariant>& variants) {
+    static const std::vector<Field> fields = Fields();
+
+    struct Axis {
+        size_t               offset;
+        std::vector<int64_t> values;
+    };
+    std::vector<Axis> axes;
+
+    char* save = nullptr;
+    for(char* item = strtok_r(line, " \t\r\n", &save); item != nullptr; item = strtok_r(nullptr, " \t\r\n", &save)) {
+        char* value = strchr(item, '=');
+        if(value == nullptr) {
+            fprintf(stderr, "%s:%d: expected key=value, got '%s'\n", path, line_number, item);
+            return false;
+        }
+        *value++ = '\0';
+
+        const Field* field = nullptr;
+        for(const Field& f : fields) {
+            if(f.name == item) {
+                field = &f;
+            }
+        }
+        if(field == nullptr) {
+            fprintf(stderr, "%s:%d: unknown field '%s'\n", path, line_number, item);
+            return false;
+        }
+
+        Axis  axis{field->offset, {}};
+        char* dots = strstr(value, "..");
+        if(dots != nullptr) {
+            const int64_t lo = strtoll(value, nullptr, 10);
+            const int64_t hi = strtoll(dots + 2, nullptr, 10);
+            for(int64_t x = lo; x <= hi; x++) {
+                axis.values.push_back(x);
+            }
+        } else {
+            char* at = nullptr;
+            for(char* t = strtok_r(value, ",", &at); t != nullptr; t = strtok_r(nullptr, ",", &at)) {
+                axis.values.push_back(strtoll(t, nullptr, 10));
+            }
+        }
+        if(axis.values.empty()) {
+            fprintf(stderr, "%s:%d: no values for '%s'\n", path, line_number, item);
+            return false;
+        }
+        axes.push_back(axis);
+    }
+
+    // Odometer over the axes, the last one fastest.
+    std::vector<size_t> at(axes.size(), 0);
+    for(;;) {
+        SweepVariant v;
+        memset(&v, 0, sizeof(v));
+        v.rules = SequencerRules::Default();
+        for(size_t a = 0; a < axes.size(); a++) {
+            SetField(v, axes[a].offset, axes[a].values[at[a]]);
+        }
+        if(!Valid(v)) {
+            fprintf(stderr, "%s:%d: a combination is outside the batch sequencer's limits\n", path, line_number);
+            return false;
+        }
+        variants.push_back(v);
+
+        size_t a = axes.size();
+        while(a > 0 && ++at[a - 1] == axes[a - 1].values.size()) {
+            at[--a] = 0;
+        }
+        if(a == 0) {
+            return true;
+        }
+    }
+}
+
+static bool ReadManifest(const char* path, std::vector<SweepVariant>& variants) {
+    FILE* f = fopen(path, "r");
+    if(f == nullptr) {
+        fprintf(stderr, "sequencer_sweep: cannot open %s\n", path);
+        return false;
+    }
+    char line[4096];
+    int  line_number = 0;
+    bool ok          = true;
+    while(ok && fgets(line, sizeof(line), f) != nullptr) {
+        line_number++;
+        const char* start = line + strspn(line, " \t");
+        if(*start == '#' || *start == '\n' || *start == '\r' || *start == '\0') {
+            continue;
+        }
+        ok = ExpandLine(line, line_number, path, variants);
+    }
+    fclose(f);
+    return ok;
+}
+
+// Runs variants [first, first + kLanes) into their streams in the mapping.
+static void RunGroup(const std::vector<SweepVariant>& variants, size_t first, uint64_t cycles, SequencerEvent* data) {
+    const int      lanes = SequencerBatch::kLanes;
+    SequencerRules rules[SequencerBatch::kLanes];
+    turing::SequencerState starts[SequencerBatch::kLanes];
+    SequencerEvent*        out[SequencerBatch::kLanes];
+
+    for(int l = 0; l < lanes; l++) {
+        const size_t index = first + static_cast<size_t>(l);
+        const bool   used  = index < variants.size();
+        const SweepVariant* v = used ? &variants[index] : &variants[first]; // spare lanes repeat the first
+
+        rules[l]  = v->rules;
+        starts[l] = turing::SequencerState();
+        turing::sequencer_init(starts[l]);
+        for(int n = 0; n < v->nudges; n++) {
+            turing::sequencer_nudge_root(starts[l]);
+        }
+        turing::sequencer_seek(starts[l], v->start_cycle);
+        out[l] = used ? data + index * cycles : nullptr;
+    }
+
+    SequencerBatch batch;
+    batch.Init(rules, starts);
+    for(uint64_t done = 0; done < cycles; done += kChunk) {
+        const uint32_t n = static_cast<uint32_t>(cycles - done < kChunk ? cycles - done : kChunk);
+        batch.Run(n, out);
+        for(int l = 0; l < lanes; l++) {
+            if(out[l] != nullptr) {
+                out[l] += n;
+            }
+        }
+    }
+}
+
+static void PrintUsage() {
+    fprintf(stderr, "usage: sequencer_sweep MANIFEST OUT.seq [--cycles N] [--jobs N]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* manifest = nullptr;
+    const char* out_path = nullptr;
+    uint64_t    cycles   = 1000000;
+    int         jobs     = static_cast<int>(std::thread::hardware_concurrency());
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if(arg[0] != '-') {
+            if(manifest == nullptr) {
+                manifest = arg;
+            } else if(out_path == nullptr) {
+                out_path = arg;
+            } else {
+                PrintUsage();
+                return 1;
+            }
+            continue;
+        }
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if(next == nullptr) {
+            PrintUsage();
+            return 1;
+        }
+        if(strcmp(arg, "--cycles") == 0) {
+            cycles = strtoull(next, nullptr, 10);
+        } else if(strcmp(arg, "--jobs") == 0) {
+            jobs = atoi(next);
+        } else {
+            PrintUsage();
+            return 1;
+        }
+        i++;
+    }
+    if(manifest == nullptr || out_path == nullptr || cycles == 0) {
+        PrintUsage();
+        return 1;
+    }
+    if(jobs < 1) {
+        jobs = 1;
+    }
+
+    std::vector<SweepVariant> variants;
+    if(!ReadManifest(manifest, variants)) {
+        return 1;
+    }
+    if(variants.empty()) {
+        fprintf(stderr, "sequencer_sweep: %s lists no variants\n", manifest);
+        return 1;
+    }
+
+    // Size and map the whole file; workers write their streams in place.
+    const uint64_t page        = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t table_end   = sizeof(SweepHeader) + variants.size() * sizeof(SweepVariant);
+    const uint64_t data_offset = (table_end + page - 1) / page * page;
+    const uint64_t total       = data_offset + variants.size() * cycles * sizeof(SequencerEvent);
+
+    const int fd = open(out_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0 || ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        fprintf(stderr, "sequencer_sweep: cannot create %s (%.1f MB)\n", out_path, total / 1e6);
+        if(fd >= 0) {
+            close(fd);
+        }
+        return 1;
+    }
+    void* const map = mmap(nullptr, static_cast<size_t>(total), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) {
+        fprintf(stderr, "sequencer_sweep: cannot map %s\n", out_path);
+        return 1;
+    }
+    char* const file = static_cast<char*>(map);
+
+    SweepHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "ATMSWEEP", 8);
+    header.version       = 1;
+    header.event_bytes   = sizeof(SequencerEvent);
+    header.variant_bytes = sizeof(SweepVariant);
+    header.variants      = static_cast<uint32_t>(variants.size());
+    header.cycles        = cycles;
+    header.data_offset   = data_offset;
+    memcpy(file, &header, sizeof(header));
+    memcpy(file + sizeof(header), variants.data(), variants.size() * sizeof(SweepVariant));
+
+    SequencerEvent* const data   = reinterpret_cast<SequencerEvent*>(file + data_offset);
+    const size_t          groups = (variants.size() + SequencerBatch::kLanes - 1) / SequencerBatch::kLanes;
+    std::vector<size_t>   order(groups);
+    for(size_t g = 0; g < groups; g++) {
+        order[g] = g * SequencerBatch::kLanes;
+    }
+    if(static_cast<size_t>(jobs) > groups) {
+        jobs = static_cast<int>(groups);
+    }
+
+    host::WorkStealingPool pool(jobs);
+    const auto             start = Clock::now();
+    pool.Run(order, [&](int, size_t first) { RunGroup(variants, first, cycles, data); });
+    const double wall_sec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const bool synced = msync(map, static_cast<size_t>(total), MS_SYNC) == 0;
+    munmap(map, static_cast<size_t>(total));
+    if(!synced) {
+        fprintf(stderr, "sequencer_sweep: write to %s failed\n", out_path);
+        return 1;
+    }
+
+    const double lane_cycles = static_cast<double>(variants.size()) * static_cast<double>(cycles);
+    printf("%zu variants x %llu cycles in %.2f s on %d threads, %d lanes (%.1f M cycles/s) -> %s (%.1f MB)\n",
+           variants.size(),
+           static_cast<unsigned long long>(cycles),
+           wall_sec,
+           jobs,
+           SequencerBatch::kLanes,
+           wall_sec > 0.0 ? lane_cycles / wall_sec * 1e-6 : 0.0,
+           out_path,
+           total / 1e6);
+    return 0;
+}
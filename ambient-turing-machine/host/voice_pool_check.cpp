@@ -0,0 +1,107 @@
+// voice_pool_check.cpp
+// Checks VoicePool allocation at the voice limit, driven the way Engine::TriggerPad
+// drives it (one Allocate + Start per layer, all layers sharing a trigger group):
+//   - a full pool: every layer of the new trigger takes its own slot;
+//   - a budget below the pool size, with free slots left over;
+//   - a pool whose only stealable voices are the trigger's own layers;
+//   - a pool where every voice is already fading out.
+// Exits non-zero on any failure.
+//
+//   voice_pool_check
+
+#include <cstdio>
+
+#include "voice_pool.h"
+
+static const int kVoices = 6; // Engine::kPadVoices with VOICES=layered
+static const int kLayers = 2; // PAD_LAYERS in ambient_engine.cpp, same build
+
+typedef ambient::VoicePool<kVoices> Pool;
+
+// Starts one trigger of `layers` voices under `limit`, the way TriggerPad does.
+// Returns the number of layers that got a slot; their slots go to slots[].
+static int Trigger(Pool& pool, int limit, uint8_t group, uint64_t now, int layers, int* slots) {
+    int started = 0;
+    for(int layer = 0; layer < layers; layer++) {
+        const int slot = pool.Allocate(limit, group);
+        if(slot < 0) {
+            continue;
+        }
+        pool.Start(slot, 2, group, now, 1.0f);
+        slots[started++] = slot;
+    }
+    return started;
+}
+
+// Fills `count` slots with held voices of distinct groups, louder the later they start.
+static void Fill(Pool& pool, int count) {
+    pool.Init();
+    int slots[kLayers];
+    for(int i = 0; i < count; i++) {
+        Trigger(pool, kVoices, static_cast<uint8_t>(100 + i), static_cast<uint64_t>(i), 1, slots);
+        pool[slots[0]].level = 0.1f * static_cast<float>(i + 1);
+    }
+}
+
+// Every layer of `group` holds a distinct slot of its own.
+static bool LayersSurvive(const Pool& pool, uint8_t group, const int* slots, int started) {
+    int count = 0;
+    for(int i = 0; i < kVoices; i++) {
+        count += pool.Active(i) && pool[i].group == group ? 1 : 0;
+    }
+    return started == kLayers && count == kLayers && slots[0] != slots[1];
+}
+
+static int Report(const char* name, bool ok) {
+    printf("%-44s %s\n", name, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+int main() {
+    int  bad = 0;
+    Pool pool;
+    int  slots[kLayers];
+
+    // Full pool, limit = pool size: both layers steal, neither steals the other.
+    Fill(pool, kVoices);
+    int started = Trigger(pool, kVoices, 7, 1000, kLayers, slots);
+    bad += Report("full pool: both layers survive", LayersSurvive(pool, 7, slots, started));
+
+    // Budget shrunk below the pool size: free slots exist but the limit is reached.
+    Fill(pool, 3);
+    started = Trigger(pool, 3, 8, 1000, kLayers, slots);
+    bad += Report("limit below pool size: both layers survive", LayersSurvive(pool, 8, slots, started) && pool.Count() == 3);
+
+    // Repeated triggers at the limit: each one keeps all its layers.
+    Fill(pool, kVoices);
+    bool ok = true;
+    for(int t = 0; t < 50; t++) {
+        const uint8_t group = static_cast<uint8_t>(t);
+        started             = Trigger(pool, kVoices - (t % 3), group, 2000 + t, kLayers, slots);
+        ok                  = ok && LayersSurvive(pool, group, slots, started);
+    }
+    bad += Report("50 triggers at a moving limit", ok);
+
+    // Only the trigger's own first layer is stealable: the second layer is dropped.
+    pool.Init();
+    started = Trigger(pool, 1, 9, 0, kLayers, slots);
+    bad += Report("own layer never stolen: second layer dropped", started == 1 && pool.Count() == 1 && pool[slots[0]].group == 9);
+
+    // Every voice fading out: nothing to steal, no slot is restarted.
+    Fill(pool, kVoices);
+    for(int i = 0; i < kVoices; i++) {
+        pool[i].shedding = true;
+    }
+    started = Trigger(pool, kVoices, 10, 3000, kLayers, slots);
+    ok      = started == 0;
+    for(int i = 0; i < kVoices; i++) {
+        ok = ok && pool[i].shedding && pool[i].group != 10;
+    }
+    bad += Report("all voices shedding: trigger dropped", ok);
+
+    if(bad > 0) {
+        printf("FAIL: %d checks\n", bad);
+        return 1;
+    }
+    return 0;
+}
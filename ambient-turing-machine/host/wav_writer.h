@@ -0,0 +1,138 @@
+// wav_writer.h
+// Minimal streaming RIFF/WAVE writer for host renders.
+// Interleaved float input; stores 16-bit PCM or 32-bit float.
+// Sizes are patched into the header on Close(). Open() can give the file a larger
+// stdio buffer so long renders reach the disk in few, large writes.
+// RIFF sizes are 32-bit: a file holds at most MaxFrames() frames (about 3.1 hours
+// of 48 kHz stereo float32, 6.2 hours of PCM16). Write() refuses anything past
+// that and Close() reports it.
+
+#ifndef HOST_WAV_WRITER_H
+#define HOST_WAV_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace host {
+
+class WavWriter {
+  public:
+    enum Format {
+        FORMAT_PCM16,
+        FORMAT_FLOAT32,
+    };
+
+    WavWriter() : file_(nullptr), frames_(0), full_(false) {}
+    ~WavWriter() { Close(); }
+
+    // Most frames a file of this layout can hold.
+    static uint64_t MaxFrames(uint16_t channels, Format format) {
+        const uint32_t bytes_per_frame = channels * (format == FORMAT_FLOAT32 ? 4u : 2u);
+        return (UINT32_MAX - kHeaderBytes) / bytes_per_frame;
+    }
+
+    // buffer_bytes: stdio buffer size for the file; 0 keeps the default (BUFSIZ).
+    bool Open(const char* path, uint32_t sample_rate, uint16_t channels, Format format, size_t buffer_bytes = 0) {
+        file_ = fopen(path, "wb");
+        if(file_ == nullptr) {
+            return false;
+        }
+        if(buffer_bytes > 0) {
+            setvbuf(file_, nullptr, _IOFBF, buffer_bytes);
+        }
+        sample_rate_ = sample_rate;
+        channels_    = channels;
+        format_      = format;
+        frames_      = 0;
+        full_        = false;
+        WriteHeader();
+        return true;
+    }
+
+    // frames * channels interleaved samples, nominally -1..1. False, writing
+    // nothing, if the file would pass MaxFrames().
+    bool Write(const float* interleaved, size_t frames) {
+        if(full_ || frames_ + frames > MaxFrames(channels_, format_)) {
+            full_ = true;
+            return false;
+        }
+        const size_t count = frames * channels_;
+        if(format_ == FORMAT_FLOAT32) {
+            fwrite(interleaved, sizeof(float), count, file_);
+        } else {
+            int16_t pcm[512];
+            size_t  done = 0;
+            while(done < count) {
+                size_t n = count - done;
+                if(n > 512) {
+                    n = 512;
+                }
+                for(size_t i = 0; i < n; i++) {
+                    float x = interleaved[done + i];
+                    x       = x > 1.0f ? 1.0f : (x < -1.0f ? -1.0f : x);
+                    pcm[i]  = static_cast<int16_t>(x * 32767.0f);
+                }
+                fwrite(pcm, sizeof(int16_t), n, file_);
+                done += n;
+            }
+        }
+        frames_ += frames;
+        return true;
+    }
+
+    // False if any write to the file failed or Write() refused frames.
+    bool Close() {
+        if(file_ == nullptr) {
+            return true;
+        }
+        fseek(file_, 0, SEEK_SET);
+        WriteHeader();
+        const bool ok     = ferror(file_) == 0;
+        const bool closed = fclose(file_) == 0;
+        file_             = nullptr;
+        return ok && closed && !full_;
+    }
+
+  private:
+    void WriteU32(uint32_t v) {
+        const uint8_t b[4] = {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8),
+                              static_cast<uint8_t>(v >> 16), static_cast<uint8_t>(v >> 24)};
+        fwrite(b, 1, 4, file_);
+    }
+
+    void WriteU16(uint16_t v) {
+        const uint8_t b[2] = {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8)};
+        fwrite(b, 1, 2, file_);
+    }
+
+    static const uint32_t kHeaderBytes = 44;
+
+    void WriteHeader() {
+        const uint16_t bytes_per_sample = format_ == FORMAT_FLOAT32 ? 4 : 2;
+        const uint32_t data_bytes = static_cast<uint32_t>(frames_ * channels_ * bytes_per_sample);
+        fwrite("RIFF", 1, 4, file_);
+        WriteU32(kHeaderBytes - 8 + data_bytes);
+        fwrite("WAVEfmt ", 1, 8, file_);
+        WriteU32(16);
+        WriteU16(format_ == FORMAT_FLOAT32 ? 3 : 1);
+        WriteU16(channels_);
+        WriteU32(sample_rate_);
+        WriteU32(sample_rate_ * channels_ * bytes_per_sample);
+        WriteU16(channels_ * bytes_per_sample);
+        WriteU16(bytes_per_sample * 8);
+        fwrite("data", 1, 4, file_);
+        WriteU32(data_bytes);
+    }
+
+    FILE*    file_;
+    uint64_t frames_;
+    uint32_t sample_rate_;
+    uint16_t channels_;
+    Format   format_;
+    bool     full_;
+};
+
+} // namespace host
+
+#endif // HOST_WAV_WRITER_H
@@ -0,0 +1,117 @@
+// work_stealing_pool.h
+// Runs a batch of independent jobs on a fixed set of threads. Jobs are dealt
+// round-robin into one deque per worker; a worker takes from the front of its own
+// deque and, once that is empty, steals from the back of the fullest other one,
+// so a worker that drew short jobs picks up what a slow one has not started.
+// Deal the jobs longest first: owners then start on their long jobs and thieves
+// take the short ones left at the back.
+// Jobs here are whole renders, so a mutex per deque costs nothing measurable.
+
+#ifndef HOST_WORK_STEALING_POOL_H
+#define HOST_WORK_STEALING_POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace host {
+
+class WorkStealingPool {
+  public:
+    struct WorkerStats {
+        size_t ran;    // jobs run, stolen ones included
+        size_t stolen; // jobs taken from another worker's deque
+    };
+
+    explicit WorkStealingPool(int workers) : queues_(workers > 0 ? workers : 1) {}
+
+    int Workers() const { return static_cast<int>(queues_.size()); }
+
+    // Runs job(worker, index) for every index in `order` and returns when all are
+    // done. Jobs must not share mutable state.
+    template <typename Job>
+    void Run(const std::vector<size_t>& order, Job job) {
+        const int workers = Workers();
+        for(size_t i = 0; i < order.size(); i++) {
+            queues_[i % workers].jobs.push_back(order[i]);
+        }
+        stats_.assign(workers, WorkerStats{0, 0});
+
+        std::vector<std::thread> threads;
+        for(int w = 1; w < workers; w++) {
+            threads.emplace_back([this, w, &job]() { Work(w, job); });
+        }
+        Work(0, job);
+        for(std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    const WorkerStats& Stats(int worker) const { return stats_[worker]; }
+
+  private:
+    struct Queue {
+        std::mutex         lock;
+        std::deque<size_t> jobs;
+    };
+
+    template <typename Job>
+    void Work(int worker, Job& job) {
+        size_t index;
+        bool   stolen;
+        while(Next(worker, index, stolen)) {
+            job(worker, index);
+            stats_[worker].ran++;
+            stats_[worker].stolen += stolen ? 1 : 0;
+        }
+    }
+
+    // Own deque first, then the back of the fullest other one. Jobs never move
+    // back into a deque, so once every deque is empty the batch is done.
+    bool Next(int worker, size_t& index, bool& stolen) {
+        {
+            Queue&                      own = queues_[worker];
+            std::lock_guard<std::mutex> hold(own.lock);
+            if(!own.jobs.empty()) {
+                index = own.jobs.front();
+                own.jobs.pop_front();
+                stolen = false;
+                return true;
+            }
+        }
+        for(;;) {
+            int    victim = -1;
+            size_t most   = 0;
+            for(int w = 0; w < Workers(); w++) {
+                if(w == worker) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> hold(queues_[w].lock);
+                if(queues_[w].jobs.size() > most) {
+                    most   = queues_[w].jobs.size();
+                    victim = w;
+                }
+            }
+            if(victim < 0) {
+                return false;
+            }
+            std::lock_guard<std::mutex> hold(queues_[victim].lock);
+            if(queues_[victim].jobs.empty()) {
+                continue; // drained since we looked
+            }
+            index = queues_[victim].jobs.back();
+            queues_[victim].jobs.pop_back();
+            stolen = true;
+            return true;
+        }
+    }
+
+    std::vector<Queue>       queues_;
+    std::vector<WorkerStats> stats_;
+};
+
+} // namespace host
+
+#endif // HOST_WORK_STEALING_POOL_H
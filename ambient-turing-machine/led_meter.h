@@ -0,0 +1,102 @@
+// led_meter.h
+// LED Meter — Block Peak/RMS per Bus and a Block-Rate Attack/Release Follower
+// The audio thread only gathers |x| peaks and sums of squares while it mixes. The
+// follower that drives the LEDs steps once per block: its per-sample attack and
+// release coefficients are raised to the block length, so a block of N samples
+// costs one update per LED instead of N.
+// Header-only, no DaisySP dependency.
+
+#ifndef LED_METER_H
+#define LED_METER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+class LedMeter {
+  public:
+    static const int kBuses = 6;
+
+    // Per-sample one-pole coefficients, as a follower running at audio rate would use.
+    void Init(float attack, float release) {
+        attack_        = attack;
+        release_       = release;
+        cached_frames_ = 0;
+        attack_n_      = 0.0f;
+        release_n_     = 0.0f;
+        for(int i = 0; i < kBuses; i++) {
+            levels_[i] = 0.0f;
+        }
+        Reset();
+    }
+
+    // Starts a new block.
+    void Reset() {
+        for(int i = 0; i < kBuses; i++) {
+            peak_[i]   = 0.0f;
+            sum_sq_[i] = 0.0f;
+        }
+        trail_  = 0.0f;
+        frames_ = 0;
+    }
+
+    void AccumulateBus(int bus, const float* x, size_t size) {
+        float peak   = peak_[bus];
+        float sum_sq = sum_sq_[bus];
+        for(size_t i = 0; i < size; i++) {
+            peak = fmaxf(peak, fabsf(x[i]));
+            sum_sq += x[i] * x[i];
+        }
+        peak_[bus]   = peak;
+        sum_sq_[bus] = sum_sq;
+    }
+
+    // Peak of a level the caller computes per sample (the effect trail).
+    void AccumulateTrail(float level) { trail_ = fmaxf(trail_, level); }
+
+    // Call once per run, after the buses, with the run length.
+    void AddFrames(size_t size) { frames_ += static_cast<uint32_t>(size); }
+
+    float    Peak(int bus) const { return peak_[bus]; }
+    float    Rms(int bus) const { return frames_ > 0 ? sqrtf(sum_sq_[bus] / static_cast<float>(frames_)) : 0.0f; }
+    float    TrailPeak() const { return trail_; }
+    uint32_t Frames() const { return frames_; }
+
+    // Moves each LED towards its target as the per-sample follower would over the
+    // block's frames if the target were constant.
+    void Follow(const float* targets) {
+        if(frames_ == 0) {
+            return;
+        }
+        if(frames_ != cached_frames_) {
+            attack_n_      = 1.0f - powf(1.0f - attack_, static_cast<float>(frames_));
+            release_n_     = 1.0f - powf(1.0f - release_, static_cast<float>(frames_));
+            cached_frames_ = frames_;
+        }
+        for(int i = 0; i < kBuses; i++) {
+            const float current = levels_[i];
+            const float coeff   = targets[i] > current ? attack_n_ : release_n_;
+            levels_[i]          = current + (targets[i] - current) * coeff;
+        }
+    }
+
+    float Level(int bus) const { return levels_[bus]; }
+
+  private:
+    float    attack_;
+    float    release_;
+    uint32_t cached_frames_; // block length attack_n_/release_n_ were computed for
+    float    attack_n_;
+    float    release_n_;
+    float    levels_[kBuses];
+    float    peak_[kBuses];
+    float    sum_sq_[kBuses];
+    float    trail_;
+    uint32_t frames_;
+};
+
+} // namespace ambient
+
+#endif // LED_METER_H
@@ -0,0 +1,70 @@
+// machine.h
+// Machine — One Complete Ambient Turing Machine Instance
+// The engine, its delay memory binding and the control state the firmware main
+// loop keeps (the smoothed BPM pot and the tempo last sent to the engine), in one
+// object instead of file-scope statics, so the host can run many independent
+// machines side by side (host/render_farm.cpp) with the same control code the
+// Seed runs. Hardware (pins, LEDs, ADC) stays in main_daisy.cpp.
+
+#ifndef MACHINE_H
+#define MACHINE_H
+
+#include <cmath>
+#include <cstddef>
+
+#include "ambient_engine.h"
+
+namespace ambient {
+
+class Machine {
+  public:
+    // BPM pot range: 0..1 maps to kMinBpm..kMaxBpm.
+    static constexpr float kMinBpm = 30.0f;
+    static constexpr float kMaxBpm = 120.0f;
+
+    static float PotForBpm(float bpm) { return (bpm - kMinBpm) / (kMaxBpm - kMinBpm); }
+
+    // The delay memory is owned by the caller, as for Engine::Init. `bpm` is the
+    // tempo the machine starts at, before the pot is first read; `start_root` and
+    // `start_cycle` as for Engine::Init.
+    void Init(float sample_rate, DelayBuffer* delay, float bpm, int start_root = 0, uint32_t start_cycle = 0) {
+        engine_.Init(sample_rate, delay, start_root, start_cycle);
+        bpm_          = bpm;
+        bpm_smoothed_ = bpm;
+        engine_.SetBpm(bpm_);
+    }
+
+    // Audio callback body.
+    void Process(float* out, size_t size) { engine_.Process(out, size); }
+
+    // One pass of the main loop (about once per millisecond on the Seed): prepares
+    // the next sequencer cycle and follows the BPM pot (0..1).
+    void Poll(float pot) {
+        // Next sequencer cycle is computed here so the audio callback only swaps it in.
+        engine_.PrepareNextCycle();
+
+        const float bpm_target = kMinBpm + pot * (kMaxBpm - kMinBpm);
+        bpm_smoothed_ += (bpm_target - bpm_smoothed_) * 0.02f;
+
+        // A full control queue leaves bpm unchanged, so the change is retried next pass.
+        if(fabsf(bpm_smoothed_ - bpm_) > 0.02f && engine_.SetBpm(bpm_smoothed_)) {
+            bpm_ = bpm_smoothed_;
+        }
+    }
+
+    // Root-advance button press.
+    bool NudgeRoot() { return engine_.RequestRootNudge(); }
+
+    Engine&       GetEngine() { return engine_; }
+    const Engine& GetEngine() const { return engine_; }
+    float         Bpm() const { return bpm_; }
+
+  private:
+    Engine engine_;
+    float  bpm_;          // tempo last accepted by the engine
+    float  bpm_smoothed_; // pot reading after smoothing
+};
+
+} // namespace ambient
+
+#endif // MACHINE_H
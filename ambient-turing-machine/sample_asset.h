@@ -0,0 +1,86 @@
+// sample_asset.h
+// Sample Asset — Binary Sample Blob and the View Over It
+// tools/convert_sample.py writes each bed as one little-endian blob: a 32-byte
+// header followed by the encoded blocks (see sample_stream.h). The Seed links the
+// blob into flash with .incbin (sample_blob.cpp); the host maps the file at run time
+// (host/sample_data_mmap.cpp). Both end up as a SampleView, which is all the engine sees.
+
+#ifndef SAMPLE_ASSET_H
+#define SAMPLE_ASSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "sample_stream.h"
+
+namespace ambient {
+
+static const uint32_t kSampleBlobMagic   = 0x42535441u; // "ATSB"
+static const uint16_t kSampleBlobVersion = 1;
+
+struct SampleBlobHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t  codec; // SampleCodec
+    uint8_t  reserved;
+    uint32_t sample_rate;
+    uint32_t length;        // samples
+    uint32_t loop_start;    // loop region in samples, loop_start < loop_end <= length
+    uint32_t loop_end;
+    uint32_t block_samples; // kSampleBlockSamples
+    uint32_t data_bytes;    // encoded bytes following the header
+};
+static_assert(sizeof(SampleBlobHeader) == 32, "blob header layout is shared with the converter");
+
+struct SampleView {
+    const uint8_t* data; // encoded blocks
+    uint32_t       length;
+    uint32_t       sample_rate;
+    uint32_t       loop_start;
+    uint32_t       loop_end;
+    SampleCodec    codec;
+};
+
+// Validates a blob and fills `view`; on failure the view is left empty (length 0),
+// which the sample player renders as silence.
+inline bool ParseSampleBlob(const uint8_t* blob, size_t size, SampleView& view) {
+    view = SampleView{nullptr, 0, 0, 0, 0, SAMPLE_CODEC_PCM16};
+    if(blob == nullptr || size < sizeof(SampleBlobHeader)) {
+        return false;
+    }
+
+    SampleBlobHeader h;
+    memcpy(&h, blob, sizeof(h));
+    if(h.magic != kSampleBlobMagic || h.version != kSampleBlobVersion || h.block_samples != kSampleBlockSamples) {
+        return false;
+    }
+    if(h.codec != SAMPLE_CODEC_PCM16 && h.codec != SAMPLE_CODEC_IMA_ADPCM) {
+        return false;
+    }
+    if(h.sample_rate == 0) {
+        return false;
+    }
+
+    const uint64_t blocks = (static_cast<uint64_t>(h.length) + kSampleBlockSamples - 1) / kSampleBlockSamples;
+    const uint64_t needed = h.codec == SAMPLE_CODEC_IMA_ADPCM ? blocks * kAdpcmBlockBytes
+                                                              : static_cast<uint64_t>(h.length) * 2u;
+    if(h.data_bytes < needed || size - sizeof(SampleBlobHeader) < h.data_bytes) {
+        return false;
+    }
+    if(!(h.loop_start < h.loop_end && h.loop_end <= h.length)) {
+        return false;
+    }
+
+    view.data        = blob + sizeof(SampleBlobHeader);
+    view.length      = h.length;
+    view.sample_rate = h.sample_rate;
+    view.loop_start  = h.loop_start;
+    view.loop_end    = h.loop_end;
+    view.codec       = static_cast<SampleCodec>(h.codec);
+    return true;
+}
+
+} // namespace ambient
+
+#endif // SAMPLE_ASSET_H
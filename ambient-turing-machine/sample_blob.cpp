@@ -0,0 +1,32 @@
+// sample_blob.cpp
+// Links the sample blob (SAMPLE_BLOB_PATH, set by the Makefile) into flash with
+// .incbin, so swapping beds only reassembles this file instead of compiling a
+// generated array. With APP_TYPE = BOOT_QSPI the read-only data lives in QSPI.
+
+#include "sample_data.h"
+
+#ifndef SAMPLE_BLOB_PATH
+#error "SAMPLE_BLOB_PATH must name the blob written by tools/convert_sample.py"
+#endif
+
+__asm__(".section .rodata.sample_blob,\"a\",%progbits\n"
+        ".balign 4\n"
+        ".global sample_blob_start\n"
+        "sample_blob_start:\n"
+        ".incbin \"" SAMPLE_BLOB_PATH "\"\n"
+        ".global sample_blob_end\n"
+        "sample_blob_end:\n"
+        ".previous\n");
+
+extern "C" const uint8_t sample_blob_start[];
+extern "C" const uint8_t sample_blob_end[];
+
+ambient::SampleView sample_data;
+
+bool LoadLinkedSampleData() {
+    return ambient::ParseSampleBlob(sample_blob_start, static_cast<size_t>(sample_blob_end - sample_blob_start), sample_data);
+}
+
+bool MapSampleData(const char*) {
+    return false;
+}
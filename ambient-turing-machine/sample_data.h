@@ -1,9 +1,17 @@
 #ifndef SAMPLE_DATA_H
 #define SAMPLE_DATA_H
 
-#include <cstdint>
+#include "sample_asset.h"
 
-extern const uint32_t sample_data_length;
-extern const int16_t sample_data[];
+// The sample bed the engine plays: a view over the blob written by
+// tools/convert_sample.py. Empty (silent) until one of the loaders succeeds.
+extern ambient::SampleView sample_data;
+
+// Seed: parses the blob linked into flash by sample_blob.cpp.
+bool LoadLinkedSampleData();
+
+// Host: maps the blob file read-only (host/sample_data_mmap.cpp). The mapping
+// stays valid for the life of the process.
+bool MapSampleData(const char* path);
 
 #endif // SAMPLE_DATA_H
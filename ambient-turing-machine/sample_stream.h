@@ -0,0 +1,160 @@
+// sample_stream.h
+// Sample Stream — Block-Compressed Sample Bed With a Decode-Ahead Ring
+// The converted sample (tools/convert_sample.py) is stored as fixed-size
+// blocks, either raw PCM16 or IMA-ADPCM (4 bits/sample, ~3.9x smaller). The player
+// asks for a range of play positions before each run; whole blocks are decoded into
+// a small ring just ahead of it, so only the ring lives in RAM.
+//
+// Play positions are unwrapped: the stream plays the intro [0, loop_start) once and
+// then repeats [loop_start, loop_end), and a position's ring slot is
+// `pos & kRingMask`. The loop seam (crossfaded offline by the converter) therefore
+// needs no special case in the reader, and uint32 wrap-around after ~24 h at 48 kHz
+// is harmless because the ring size divides 2^32. The first kRingGuard slots are
+// mirrored past the end of the ring, so Frame() can hand out an interpolation
+// window without masking each tap.
+//
+// ADPCM block (kAdpcmBlockBytes): int16 first sample (little endian), uint8 step
+// index, uint8 reserved, then 4-bit codes for samples 1..255, low nibble first.
+// The decoder matches the encoder in the converter bit for bit.
+
+#ifndef SAMPLE_STREAM_H
+#define SAMPLE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ambient {
+
+enum SampleCodec : uint8_t {
+    SAMPLE_CODEC_PCM16     = 0, // little-endian int16
+    SAMPLE_CODEC_IMA_ADPCM = 1,
+};
+
+static const uint32_t kSampleBlockSamples = 256;
+static const uint32_t kAdpcmBlockBytes    = 4 + kSampleBlockSamples / 2;
+
+// Decodes samples [first, end) (end <= kSampleBlockSamples) of one ADPCM block,
+// writing sample i to ring[(pos + i - first) & mask]. Samples before `first` are
+// still decoded, since each one depends on the previous.
+inline void AdpcmDecodeBlock(const uint8_t* block, uint32_t first, uint32_t end, int16_t* ring, uint32_t pos, uint32_t mask) {
+    static const int16_t kStepTable[89] = {
+        7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+        31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+        130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+        544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+        2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+        9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+    };
+    static const int8_t kIndexTable[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+    int32_t pred  = static_cast<int16_t>(static_cast<uint16_t>(block[0] | (block[1] << 8)));
+    int32_t index = block[2] > 88 ? 88 : block[2];
+    if(first == 0) {
+        ring[pos & mask] = static_cast<int16_t>(pred);
+    }
+
+    const uint8_t* codes = block + 4;
+    for(uint32_t i = 1; i < end; i++) {
+        const uint32_t k    = i - 1;
+        const uint32_t code = (codes[k >> 1] >> ((k & 1u) << 2)) & 0xFu;
+        const int32_t  step = kStepTable[index];
+
+        int32_t diff = step >> 3;
+        if(code & 4u) {
+            diff += step;
+        }
+        if(code & 2u) {
+            diff += step >> 1;
+        }
+        if(code & 1u) {
+            diff += step >> 2;
+        }
+        pred = (code & 8u) ? pred - diff : pred + diff;
+        pred = pred > 32767 ? 32767 : (pred < -32768 ? -32768 : pred);
+
+        index += kIndexTable[code];
+        index = index > 88 ? 88 : (index < 0 ? 0 : index);
+
+        if(i >= first) {
+            ring[(pos + i - first) & mask] = static_cast<int16_t>(pred);
+        }
+    }
+}
+
+class SampleStream {
+  public:
+    // Decoded samples held in RAM. Must exceed the longest FillTo span plus one block.
+    static const uint32_t kRingSize = 1024;
+    static const uint32_t kRingMask = kRingSize - 1;
+    // Slots readable past Frame(pos): enough for a 4-point window starting at pos.
+    static const uint32_t kRingGuard = 3;
+
+    // `data` holds ceil(length / kSampleBlockSamples) blocks of `codec`; the last
+    // block is padded. Requires loop_start < loop_end <= length (checked by
+    // ParseSampleBlob). The stream starts at play position 0.
+    void Init(const uint8_t* data, uint32_t length, SampleCodec codec, uint32_t loop_start, uint32_t loop_end) {
+        data_        = data;
+        length_      = length;
+        loop_start_  = loop_start;
+        loop_end_    = loop_end;
+        codec_       = codec;
+        next_sample_ = 0;
+        decoded_end_ = 0;
+        memset(ring_, 0, sizeof(ring_));
+    }
+
+    uint32_t Length() const { return length_; }
+
+    // Decodes ahead until every position before `end` is in the ring. The caller
+    // must not read positions more than kRingSize - kSampleBlockSamples behind `end`.
+    void FillTo(uint32_t end) {
+        while(loop_end_ > 0 && static_cast<int32_t>(end - decoded_end_) > 0) {
+            DecodeNextRun();
+        }
+    }
+
+    int16_t At(uint32_t pos) const { return ring_[pos & kRingMask]; }
+
+    // Samples pos .. pos + kRingGuard, contiguous in memory.
+    const int16_t* Frame(uint32_t pos) const { return &ring_[pos & kRingMask]; }
+
+  private:
+    // Decodes from next_sample_ to the end of its block or of the loop, whichever
+    // comes first, then jumps back to loop_start_ at the loop end.
+    void DecodeNextRun() {
+        const uint32_t block     = next_sample_ / kSampleBlockSamples;
+        const uint32_t first     = next_sample_ - block * kSampleBlockSamples;
+        const uint32_t block_end = (block + 1u) * kSampleBlockSamples;
+        const uint32_t run_end   = block_end < loop_end_ ? block_end : loop_end_;
+        const uint32_t count     = run_end - next_sample_;
+
+        if(codec_ == SAMPLE_CODEC_IMA_ADPCM) {
+            AdpcmDecodeBlock(data_ + block * kAdpcmBlockBytes, first, first + count, ring_, decoded_end_, kRingMask);
+        } else {
+            // Two copies at most: the run may straddle the end of the ring.
+            const uint8_t* src   = data_ + next_sample_ * 2u;
+            const uint32_t slot  = decoded_end_ & kRingMask;
+            const uint32_t first_part = kRingSize - slot < count ? kRingSize - slot : count;
+            memcpy(&ring_[slot], src, first_part * 2u);
+            memcpy(&ring_[0], src + first_part * 2u, (count - first_part) * 2u);
+        }
+        memcpy(&ring_[kRingSize], &ring_[0], kRingGuard * sizeof(int16_t));
+
+        decoded_end_ += count;
+        next_sample_ = run_end == loop_end_ ? loop_start_ : run_end;
+    }
+
+    const uint8_t* data_;
+    uint32_t       length_;
+    uint32_t       loop_start_;
+    uint32_t       loop_end_;
+    uint32_t       next_sample_; // sample index of the next decode, back to loop_start_ after loop_end_
+    uint32_t       decoded_end_; // play position after the last decoded sample
+    SampleCodec    codec_;
+    int16_t        ring_[kRingSize + kRingGuard]; // [kRingSize..] mirrors [0..kRingGuard)
+};
+
+} // namespace ambient
+
+#endif // SAMPLE_STREAM_H
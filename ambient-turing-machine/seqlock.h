@@ -0,0 +1,76 @@
+// seqlock.h
+// Seqlock Snapshot — Tear-Free Readback From the Audio Callback
+// The audio thread publishes a small struct (meters, clock) once per callback;
+// the main loop reads a consistent copy without ever blocking the writer.
+// Storage is 32-bit relaxed atomics, so torn reads are detected, never undefined.
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ambient {
+
+template <typename T>
+class SeqlockSnapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot type must be trivially copyable");
+    static const uint32_t kWords = (sizeof(T) + 3u) / 4u;
+
+  public:
+    SeqlockSnapshot() : seq_(0) {
+        for(uint32_t i = 0; i < kWords; i++) {
+            words_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Single writer (audio thread).
+    void Write(const T& value) {
+        uint32_t words[kWords] = {};
+        memcpy(words, &value, sizeof(T));
+
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for(uint32_t i = 0; i < kWords; i++) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2u, std::memory_order_release);
+    }
+
+    // One attempt; returns false if the writer was active. Safe from an interrupt.
+    bool TryRead(T& value) const {
+        const uint32_t seq = seq_.load(std::memory_order_acquire);
+        if(seq & 1u) {
+            return false;
+        }
+        uint32_t words[kWords];
+        for(uint32_t i = 0; i < kWords; i++) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(seq_.load(std::memory_order_relaxed) != seq) {
+            return false;
+        }
+        memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    // Retries until a consistent copy is read. Readers only; never call from the writer's context.
+    T Read() const {
+        T value;
+        while(!TryRead(value)) {
+        }
+        return value;
+    }
+
+  private:
+    std::atomic<uint32_t> seq_;
+    std::atomic<uint32_t> words_[kWords];
+};
+
+} // namespace ambient
+
+#endif // SEQLOCK_H
@@ -0,0 +1,166 @@
+// sequencer_lookahead.h
+// Sequencer Lookahead — Next Cycle Computed Outside the Audio Callback
+// The main loop (or any lower-priority context) ticks the sequencer
+// (turing::DefaultRules, the compiled form of sequencer_tick) for the coming
+// cycle into a spare slot; at the cycle boundary the audio thread only
+// flips an index. If the spare slot is not ready in time the audio thread ticks
+// inline as before, so the sequence never depends on main-loop timing.
+//
+// One producer (Prepare) and one consumer (Live, Advance); RequestNudge is safe
+// from either side. Lock-free on the Seed (32-bit atomics) and on the host.
+
+#ifndef SEQUENCER_LOOKAHEAD_H
+#define SEQUENCER_LOOKAHEAD_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "sequencer_rules.h"
+#include "turing_sequencer.h"
+
+namespace ambient {
+
+class SequencerLookahead {
+  public:
+    // start_root: circle-of-fifths position the first tick plays, as if the root
+    // had been nudged that many times before it. start_cycle: the cycle the first
+    // tick plays, as if the sequencer had run from there (sequencer_seek); ignored
+    // unless it lies beyond the nudged start.
+    void Init(int start_root = 0, uint32_t start_cycle = 0) {
+        turing::sequencer_init(slots_[0].state);
+        for(int i = 0; i < start_root; i++) {
+            turing::sequencer_nudge_root(slots_[0].state);
+        }
+        turing::sequencer_seek(slots_[0].state, start_cycle);
+        slots_[0].ticks  = 0;
+        slots_[0].nudged = false;
+        live_.store(0, std::memory_order_relaxed);
+        live_seq_.store(0, std::memory_order_relaxed);
+        spare_state_.store(SPARE_FREE, std::memory_order_relaxed);
+        nudge_request_.store(false, std::memory_order_relaxed);
+        underruns_ = 0;
+    }
+
+    // Advance the root at the next cycle boundary. A lookahead that was already
+    // prepared without it is taken back and recomputed by the next Prepare().
+    // Sequentially consistent with Prepare()'s publish: either this sees READY and
+    // takes it back, or Prepare() sees the request and drops its spare.
+    void RequestNudge() {
+        nudge_request_.store(true);
+        uint32_t expected = SPARE_READY;
+        spare_state_.compare_exchange_strong(expected, SPARE_FREE);
+    }
+
+    // ---- Producer side (main loop) ----
+
+    // Computes the next cycle if the spare slot is free. Returns true when it did work.
+    bool Prepare() {
+        return Prepare([] {});
+    }
+
+    // As Prepare(), calling before_publish() between the tick and the publish, where
+    // a nudge can land after the request was read (host/sequencer_lookahead_check).
+    template <typename Hook>
+    bool Prepare(Hook before_publish) {
+        uint32_t expected = SPARE_FREE;
+        if(!spare_state_.compare_exchange_strong(expected, SPARE_WRITING, std::memory_order_acquire)) {
+            return false;
+        }
+
+        const int live  = live_.load(std::memory_order_acquire);
+        Slot&     spare = slots_[1 - live];
+
+        // The live slot only changes in place on an underrun; retry if that overlapped the copy.
+        uint32_t seq;
+        do {
+            seq = live_seq_.load(std::memory_order_acquire);
+            if(seq & 1u) {
+                continue;
+            }
+            spare.state = slots_[live].state;
+            spare.ticks = slots_[live].ticks;
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while((seq & 1u) || seq != live_seq_.load(std::memory_order_relaxed));
+
+        spare.nudged = nudge_request_.exchange(false, std::memory_order_acq_rel);
+        if(spare.nudged) {
+            turing::sequencer_nudge_root(spare.state);
+        }
+        turing::DefaultRules::Tick(spare.state);
+        spare.ticks++;
+        before_publish();
+
+        // A nudge that arrived after the request was read could not take this spare
+        // back (it was not READY yet): drop it so the next Prepare() recomputes it
+        // with the nudge. If Advance() took it first, the nudge stays pending.
+        spare_state_.store(SPARE_READY);
+        if(nudge_request_.load()) {
+            expected = SPARE_READY;
+            spare_state_.compare_exchange_strong(expected, SPARE_FREE);
+        }
+        return true;
+    }
+
+    // ---- Consumer side (audio thread) ----
+
+    const turing::SequencerState& Live() const { return slots_[live_.load(std::memory_order_relaxed)].state; }
+
+    // Moves to the next cycle: publishes the prepared slot, or ticks inline if it is
+    // missing or was computed from a cycle that has since been replaced.
+    void Advance() {
+        const int live     = live_.load(std::memory_order_relaxed);
+        const int spare    = 1 - live;
+        uint32_t  expected = SPARE_READY;
+
+        if(spare_state_.compare_exchange_strong(expected, SPARE_TAKEN, std::memory_order_acquire)) {
+            const bool current = slots_[spare].ticks == slots_[live].ticks + 1u;
+            if(current) {
+                live_.store(spare, std::memory_order_release);
+            } else if(slots_[spare].nudged) {
+                nudge_request_.store(true, std::memory_order_relaxed);
+            }
+            spare_state_.store(SPARE_FREE, std::memory_order_release);
+            if(current) {
+                return;
+            }
+        }
+
+        underruns_++;
+        live_seq_.fetch_add(1u, std::memory_order_acq_rel);
+        Slot& slot = slots_[live];
+        if(nudge_request_.exchange(false, std::memory_order_acq_rel)) {
+            turing::sequencer_nudge_root(slot.state);
+        }
+        turing::DefaultRules::Tick(slot.state);
+        slot.ticks++;
+        live_seq_.fetch_add(1u, std::memory_order_release);
+    }
+
+    // Cycle boundaries that had to tick on the audio thread.
+    uint32_t Underruns() const { return underruns_; }
+
+  private:
+    enum : uint32_t {
+        SPARE_FREE,    // producer may claim the spare slot
+        SPARE_WRITING, // producer is filling it
+        SPARE_READY,   // holds the next cycle
+        SPARE_TAKEN,   // consumer is publishing it
+    };
+
+    struct Slot {
+        turing::SequencerState state;
+        uint32_t               ticks; // ticks since Init
+        bool                   nudged;
+    };
+
+    Slot                  slots_[2];
+    std::atomic<int>      live_;
+    std::atomic<uint32_t> live_seq_;
+    std::atomic<uint32_t> spare_state_;
+    std::atomic<bool>     nudge_request_;
+    uint32_t              underruns_;
+};
+
+} // namespace ambient
+
+#endif // SEQUENCER_LOOKAHEAD_H
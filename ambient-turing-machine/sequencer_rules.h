@@ -0,0 +1,369 @@
+// sequencer_rules.h
+// Sequencer Rules — Voice Behaviours as Compile-Time Descriptors
+// The six voices of turing_sequencer.h written declaratively: each voice is a
+// gate rule plus a pitch rule, and Machine<...> compiles a set of six into a
+// tick specialised for those constants. Fixed and walking voices read their
+// notes from tables built at compile time for every root; followers split their
+// degree once and clamp from the pitch class. Frequencies and display fields come
+// from one constexpr MIDI table, so a tick has no transcendental math, no loops
+// over octaves and no rule dispatch at run time.
+//
+// DefaultRules is the machine in turing_sequencer.h; its Tick leaves exactly the
+// state sequencer_tick does (host/build/sequencer_rules_check), and the engine
+// ticks with it. sequencer_tick stays as the readable reference.
+//
+// Voices are numbered 0-5 here, as indices into SequencerState::voices. The state
+// has follower slots for voices 1, 3 and 5 (frozen_v2/v4/v6_degree), one trigger
+// time (last_v2_trigger_cycle) and one walk history (v5_history), so a machine
+// has at most one EveryIfWasOn gate and one Walk voice, and followers sit at 1, 3, 5.
+
+#ifndef SEQUENCER_RULES_H
+#define SEQUENCER_RULES_H
+
+#include <cstdint>
+
+#include "fast_math.h"
+#include "turing_sequencer.h"
+
+namespace turing {
+
+// =============================================
+// COMPILE-TIME TABLES
+// =============================================
+
+struct MidiTable {
+    float   freq[128];       // midi_to_freq
+    uint8_t note_index[128]; // midi_to_note_info
+    uint8_t octave[128];
+};
+
+constexpr MidiTable MakeMidiTable() {
+    MidiTable t{};
+    float     scale = 1.0f; // 2^octave, exact
+    for(int midi = 0; midi < 128; midi++) {
+        if(midi > 0 && midi % 12 == 0) {
+            scale *= 2.0f;
+        }
+        t.freq[midi]       = fastmath::kMidiOctaveZero[midi % 12] * scale;
+        t.note_index[midi] = static_cast<uint8_t>(midi % 12);
+        t.octave[midi]     = static_cast<uint8_t>(midi / 12);
+    }
+    return t;
+}
+
+constexpr MidiTable kMidiTable = MakeMidiTable();
+
+static_assert(kMidiTable.freq[69] == 440.0f, "A4");
+
+// root + MAJOR_SCALE[step] (0..22) for each root chromatic index and step 0..6.
+struct ScalePitchTable {
+    int8_t pitch[12][7];
+};
+
+constexpr ScalePitchTable MakeScalePitchTable() {
+    ScalePitchTable t{};
+    for(int root = 0; root < 12; root++) {
+        for(int step = 0; step < 7; step++) {
+            t.pitch[root][step] = static_cast<int8_t>(root + MAJOR_SCALE[step]);
+        }
+    }
+    return t;
+}
+
+constexpr ScalePitchTable kScalePitchTable = MakeScalePitchTable();
+
+// degree_to_midi for a degree only known at run time, without its divisions by 12:
+// the clamp keeps the pitch class and the bound sits on a C (min octave), so it is
+// a table lookup. Division by 7 is by a constant.
+inline int follower_midi(int root_chromatic, int degree, int base_octave, int min_octave) {
+    const int oct   = degree >= 0 ? degree / 7 : (degree - 6) / 7;
+    const int pitch = kScalePitchTable.pitch[root_chromatic][degree - oct * 7];
+    const int pc    = pitch >= 12 ? pitch - 12 : pitch;
+
+    int midi = (base_octave + oct) * 12 + pitch;
+    if(midi < min_octave * 12) {
+        midi = min_octave * 12 + pc;
+    }
+    return midi;
+}
+
+inline int& frozen_degree(SequencerState& s, int voice) {
+    return voice == 1 ? s.frozen_v2_degree : voice == 3 ? s.frozen_v4_degree : s.frozen_v6_degree;
+}
+
+// =============================================
+// GATE RULES
+// =============================================
+// static bool Gate(SequencerState& s, uint32_t cycle): is the voice on this cycle.
+// Gates are evaluated in voice order, after prev_gate has been saved.
+
+// On for the first `On` cycles of every `Period`.
+template <uint32_t Period, uint32_t On = 1>
+struct Every {
+    static_assert(Period > 0, "period");
+    static bool Gate(SequencerState&, uint32_t cycle) { return cycle % Period < On; }
+};
+
+// Fires at the start of every `Period` if voice `Source` was on last cycle, and
+// records the trigger time (the Mirror).
+template <uint32_t Period, int Source>
+struct EveryIfWasOn {
+    static bool Gate(SequencerState& s, uint32_t cycle) {
+        if(cycle % Period == 0 && s.voices[Source].prev_gate) {
+            s.last_v2_trigger_cycle = static_cast<int>(cycle);
+            return true;
+        }
+        return false;
+    }
+};
+
+// Fires at the start of every `Period` within `Window` cycles of the recorded
+// trigger (the Wanderer). Place it after the EveryIfWasOn voice.
+template <uint32_t Period, int Window>
+struct EveryAfterTrigger {
+    static bool Gate(SequencerState& s, uint32_t cycle) {
+        return cycle % Period == 0 && (static_cast<int>(cycle) - s.last_v2_trigger_cycle) <= Window;
+    }
+};
+
+// =============================================
+// PITCH RULES
+// =============================================
+// template <int I> static void Apply(SequencerState& s, const Context& c): sets
+// voice I's degree, octave and midi_note. Sources run first (kFollower false),
+// then followers in voice order, as in sequencer_tick.
+
+struct Context {
+    uint32_t cycle;
+    int      root;      // chromatic root 0-11
+    bool     gates[6];  // this cycle's gates
+    int      before[6]; // follower degrees at the start of the tick (slots 1, 3, 5)
+};
+
+// A constant degree and octave.
+template <int Degree, int Octave, int MinOctave = -1>
+struct Fixed {
+    static const bool kFollower = false;
+
+    struct Notes {
+        int8_t midi[12];
+    };
+    static constexpr Notes MakeNotes() {
+        Notes n{};
+        for(int root = 0; root < 12; root++) {
+            n.midi[root] = static_cast<int8_t>(degree_to_midi(root, Degree, Octave, MinOctave));
+        }
+        return n;
+    }
+
+    template <int I>
+    static void Apply(SequencerState& s, const Context& c) {
+        static constexpr Notes kNotes = MakeNotes();
+        static_assert(Octave * 12 + 22 <= 127, "notes within MIDI range");
+        Voice& v    = s.voices[I];
+        v.degree    = Degree;
+        v.octave    = Octave;
+        v.midi_note = kNotes.midi[c.root];
+    }
+};
+
+// Walks degrees 0..Length-1, one step every `Hold` cycles, in octave OctaveOn
+// while voice `GateVoice` is on this cycle and OctaveOff otherwise; notes at or
+// above `Ceiling` drop an octave. Keeps the walk history (the Scale Walker).
+template <uint32_t Hold, uint32_t Length, int GateVoice, int OctaveOn, int OctaveOff, int MinOctave, int Ceiling>
+struct Walk {
+    static const bool kFollower = false;
+    static_assert(Hold > 0 && Length > 0 && Length <= 7, "walk within one scale");
+
+    struct Notes {
+        int8_t midi[12][Length][2]; // [root][step][on ? 0 : 1]
+    };
+    static constexpr Notes MakeNotes() {
+        Notes n{};
+        for(int root = 0; root < 12; root++) {
+            for(int step = 0; step < static_cast<int>(Length); step++) {
+                for(int off = 0; off < 2; off++) {
+                    int midi = degree_to_midi(root, step, off ? OctaveOff : OctaveOn, MinOctave);
+                    if(midi >= Ceiling) {
+                        midi -= 12;
+                    }
+                    n.midi[root][step][off] = static_cast<int8_t>(midi);
+                }
+            }
+        }
+        return n;
+    }
+
+    template <int I>
+    static void Apply(SequencerState& s, const Context& c) {
+        static constexpr Notes kNotes = MakeNotes();
+        const int              step   = static_cast<int>(c.cycle / Hold % Length);
+        const bool             on     = c.gates[GateVoice];
+        Voice&                 v      = s.voices[I];
+        v.degree                      = step;
+        v.octave                      = on ? OctaveOn : OctaveOff;
+        v.midi_note                   = kNotes.midi[c.root][step][on ? 0 : 1];
+        s.v5_history[1]               = s.v5_history[0];
+        s.v5_history[0]               = step;
+    }
+};
+
+// On its gate, moves by `Up` when the walk stepped up and `Down` when it stepped
+// down (the Mirror).
+template <int Up, int Down, int Octave, int MinOctave>
+struct Mirror {
+    static const bool kFollower = true;
+    static_assert(MinOctave >= 0, "followers need a lowest octave");
+
+    template <int I>
+    static void Apply(SequencerState& s, const Context& c) {
+        int& degree = frozen_degree(s, I);
+        if(c.gates[I]) {
+            const int step = s.v5_history[0];
+            const int prev = s.v5_history[1];
+            degree += step > prev ? Up : step < prev ? Down : 0;
+        }
+        Voice& v    = s.voices[I];
+        v.degree    = degree;
+        v.octave    = Octave;
+        v.midi_note = follower_midi(c.root, degree, Octave, MinOctave);
+    }
+};
+
+// On its gate, moves by one of four amounts picked by whether voices A and B
+// were on last cycle (the Wanderer).
+template <int A, int B, int Both, int AOnly, int BOnly, int Neither, int Octave, int MinOctave>
+struct Wanderer {
+    static const bool kFollower = true;
+    static_assert(MinOctave >= 0, "followers need a lowest octave");
+
+    template <int I>
+    static void Apply(SequencerState& s, const Context& c) {
+        int& degree = frozen_degree(s, I);
+        if(c.gates[I]) {
+            const bool a = s.voices[A].prev_gate;
+            const bool b = s.voices[B].prev_gate;
+            degree += a ? (b ? Both : AOnly) : (b ? BOnly : Neither);
+        }
+        Voice& v    = s.voices[I];
+        v.degree    = degree;
+        v.octave    = Octave;
+        v.midi_note = follower_midi(c.root, degree, Octave, MinOctave);
+    }
+};
+
+// On its gate, copies voice `Source`'s degree from before this tick; plays in
+// OctaveOn if voice `OctaveVoice` was on last cycle, else OctaveOff, dropping an
+// octave at or above `Ceiling` (the Echo).
+template <int Source, int OctaveVoice, int OctaveOn, int OctaveOff, int MinOctave, int Ceiling>
+struct Echo {
+    static const bool kFollower = true;
+    static_assert(MinOctave >= 0 && Ceiling >= MinOctave * 12 + 12, "followers need a lowest octave below the ceiling");
+
+    template <int I>
+    static void Apply(SequencerState& s, const Context& c) {
+        int& degree = frozen_degree(s, I);
+        if(c.gates[I]) {
+            degree = c.before[Source];
+        }
+        const int octave = s.voices[OctaveVoice].prev_gate ? OctaveOn : OctaveOff;
+        int       midi   = follower_midi(c.root, degree, octave, MinOctave);
+        if(midi >= Ceiling) {
+            midi -= 12;
+        }
+        Voice& v    = s.voices[I];
+        v.degree    = degree;
+        v.octave    = octave;
+        v.midi_note = midi;
+    }
+};
+
+// =============================================
+// MACHINE
+// =============================================
+
+template <typename GateRule, typename PitchRule>
+struct VoiceRule {
+    typedef GateRule  Gate;
+    typedef PitchRule Pitch;
+};
+
+// Six VoiceRules and the number of cycles per circle-of-fifths step.
+template <typename V0, typename V1, typename V2, typename V3, typename V4, typename V5, uint32_t RootHold = 12>
+struct Machine {
+    static void Tick(SequencerState& s) {
+        const uint32_t cycle = s.cycle;
+        for(int i = 0; i < 6; i++) {
+            s.voices[i].prev_gate = s.voices[i].gate;
+        }
+
+        s.root_cycle_index = static_cast<int>(cycle / RootHold % 12);
+        s.root_chromatic   = CIRCLE_OF_FIFTHS[s.root_cycle_index];
+
+        Context c;
+        c.cycle    = cycle;
+        c.root     = s.root_chromatic;
+        c.gates[0] = V0::Gate::Gate(s, cycle);
+        c.gates[1] = V1::Gate::Gate(s, cycle);
+        c.gates[2] = V2::Gate::Gate(s, cycle);
+        c.gates[3] = V3::Gate::Gate(s, cycle);
+        c.gates[4] = V4::Gate::Gate(s, cycle);
+        c.gates[5] = V5::Gate::Gate(s, cycle);
+        for(int i = 0; i < 6; i++) {
+            s.voices[i].gate = c.gates[i];
+        }
+        c.before[0] = c.before[2] = c.before[4] = 0;
+        c.before[1] = s.frozen_v2_degree;
+        c.before[3] = s.frozen_v4_degree;
+        c.before[5] = s.frozen_v6_degree;
+        s.prev_v4_degree_for_echo = s.frozen_v4_degree;
+
+        ApplyPass<false>(s, c);
+        ApplyPass<true>(s, c);
+
+        for(int i = 0; i < 6; i++) {
+            Voice& v = s.voices[i];
+            if(static_cast<unsigned>(v.midi_note) < 128u) {
+                v.freq         = kMidiTable.freq[v.midi_note];
+                v.note_index   = kMidiTable.note_index[v.midi_note];
+                v.final_octave = kMidiTable.octave[v.midi_note];
+            } else {
+                // The Wanderer and Echo climb past MIDI 127 in long runs.
+                v.freq = midi_to_freq(v.midi_note);
+                midi_to_note_info(v.midi_note, v.note_index, v.final_octave);
+            }
+        }
+        s.cycle++;
+    }
+
+  private:
+    template <bool Followers>
+    static void ApplyPass(SequencerState& s, const Context& c) {
+        Apply<V0, 0, Followers>(s, c);
+        Apply<V1, 1, Followers>(s, c);
+        Apply<V2, 2, Followers>(s, c);
+        Apply<V3, 3, Followers>(s, c);
+        Apply<V4, 4, Followers>(s, c);
+        Apply<V5, 5, Followers>(s, c);
+    }
+
+    template <typename V, int I, bool Followers>
+    static void Apply(SequencerState& s, const Context& c) {
+        if(V::Pitch::kFollower == Followers) {
+            V::Pitch::template Apply<I>(s, c);
+        }
+    }
+};
+
+// The machine of turing_sequencer.h.
+typedef Machine<VoiceRule<Every<12, 10>, Fixed<0, 3>>,                        // Root
+                VoiceRule<EveryIfWasOn<3, 4>, Mirror<-1, 1, 3, 4>>,            // Mirror
+                VoiceRule<Every<7, 5>, Fixed<2, 3>>,                           // Third
+                VoiceRule<EveryAfterTrigger<5, 2>, Wanderer<2, 1, 1, -2, 0, 3, 3, 4>>, // Wanderer
+                VoiceRule<Every<5, 4>, Walk<3, 7, 2, 4, 3, 3, 72>>,            // Scale Walker
+                VoiceRule<Every<4>, Echo<3, 0, 4, 5, 4, 84>>>                  // Echo
+    DefaultRules;
+
+} // namespace turing
+
+#endif // SEQUENCER_RULES_H
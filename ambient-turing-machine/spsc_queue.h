@@ -0,0 +1,67 @@
+// spsc_queue.h
+// Single-Producer / Single-Consumer Ring — Main Loop to Audio Callback
+// Fixed-size ring of trivially copyable messages. One thread (or the Seed's main
+// loop) pushes, one thread (or the audio interrupt) pops; neither side blocks or
+// allocates. Head and tail are 32-bit atomics, lock-free on Cortex-M7 and x86.
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+template <typename T, uint32_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+    SpscQueue() : head_(0), tail_(0) {}
+
+    // Producer. Returns false when the ring is full.
+    bool Push(const T& item) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if(tail - head_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer. Copies the oldest item without removing it.
+    bool Peek(T& item) const {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if(head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items_[head & (Capacity - 1)];
+        return true;
+    }
+
+    // Consumer. Removes the oldest item; returns false when empty.
+    bool Pop(T& item) {
+        if(!Peek(item)) {
+            return false;
+        }
+        head_.store(head_.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; exact only from the consumer.
+    bool Empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+    void Clear() { head_.store(tail_.load(std::memory_order_acquire), std::memory_order_release); }
+
+  private:
+    // Producer and consumer indices on separate cache lines on the host.
+    alignas(64) std::atomic<uint32_t> head_;
+    alignas(64) std::atomic<uint32_t> tail_;
+    T items_[Capacity];
+};
+
+} // namespace ambient
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,297 @@
+// stage_profiler.h
+// Stage Profiler — Per-Stage Callback Timing
+// Times each stage of Engine::Process (cycle tick, triggers, voice renderers, delay,
+// reverb, LED metering) and the whole callback. Stage times are summed per callback
+// and kept as min/mean/max and a log-spaced histogram for p99.
+//
+// Built only with -DAMBIENT_PROFILE (`make PROFILE=1` on the Seed and the host);
+// otherwise the PROFILE_* macros expand to nothing and the engine carries no profiler.
+//
+// Clock: the DWT cycle counter on the Seed (Cortex-M7), steady_clock on the host.
+// The audio thread fills one histogram bank while the main loop reads the other
+// (TakeReport), so reporting never blocks or races the callback.
+
+#ifndef STAGE_PROFILER_H
+#define STAGE_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+enum ProfileStage {
+    PROFILE_CYCLE_TICK,
+    PROFILE_TRIGGERS,
+    PROFILE_DRONES,
+    PROFILE_SPARKLES,
+    PROFILE_PAD,
+    PROFILE_SAMPLER,
+    PROFILE_DELAY,
+    PROFILE_REVERB,
+    PROFILE_METERS,
+    PROFILE_CALLBACK, // whole Engine::Process call
+    PROFILE_STAGE_COUNT,
+};
+
+} // namespace ambient
+
+#if defined(AMBIENT_PROFILE)
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__arm__)
+extern "C" uint32_t SystemCoreClock; // CMSIS, set by libDaisy's clock setup
+#else
+#include <chrono>
+#endif
+
+namespace ambient {
+
+// Summary of one reporting window, in nanoseconds.
+struct ProfileStats {
+    uint32_t count; // callbacks in which the stage ran
+    uint32_t min_ns;
+    uint32_t mean_ns;
+    uint32_t max_ns;
+    uint32_t p99_ns; // upper edge of the histogram bucket, at most 12.5% high
+};
+
+struct ProfileReport {
+    ProfileStats stages[PROFILE_STAGE_COUNT];
+};
+
+class StageProfiler {
+  public:
+    // Raw timestamp in profiler ticks (CPU cycles on the Seed, ns on the host).
+    static inline uint32_t Now() {
+#if defined(__arm__)
+        return *reinterpret_cast<volatile uint32_t*>(0xE0001004u); // DWT_CYCCNT
+#else
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+    void Init() {
+#if defined(__arm__)
+        // Enable the cycle counter: DEMCR.TRCENA, unlock DWT (needed on the H7), CYCCNTENA.
+        *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu) |= (1u << 24);
+        *reinterpret_cast<volatile uint32_t*>(0xE0001FB0u) = 0xC5ACCE55u;
+        *reinterpret_cast<volatile uint32_t*>(0xE0001004u) = 0u;
+        *reinterpret_cast<volatile uint32_t*>(0xE0001000u) |= 1u;
+#endif
+        for(int b = 0; b < 2; b++) {
+            ClearBank(banks_[b]);
+        }
+        memset(pending_, 0, sizeof(pending_));
+        ran_ = 0;
+        active_.store(0, std::memory_order_relaxed);
+        request_.store(REPORT_IDLE, std::memory_order_relaxed);
+    }
+
+    // ---- Audio thread ----
+
+    void BeginCallback() { callback_start_ = Now(); }
+
+    void Add(ProfileStage stage, uint32_t start) {
+        pending_[stage] += Now() - start;
+        ran_ |= 1u << stage;
+    }
+
+    // Records the per-callback stage sums; swaps banks if the main loop asked for a report.
+    void EndCallback() {
+        Add(PROFILE_CALLBACK, callback_start_);
+
+        Bank& bank = banks_[active_.load(std::memory_order_relaxed)];
+        for(int s = 0; s < PROFILE_STAGE_COUNT; s++) {
+            if(ran_ & (1u << s)) {
+                Record(bank.stages[s], pending_[s]);
+                pending_[s] = 0;
+            }
+        }
+        ran_ = 0;
+
+        if(request_.load(std::memory_order_acquire) == REPORT_REQUESTED) {
+            active_.store(1 - active_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            request_.store(REPORT_READY, std::memory_order_release);
+        }
+    }
+
+    // ---- Main loop ----
+
+    // Call periodically. Returns true with the window since the previous report once
+    // the audio thread has handed its bank over; otherwise asks for the next one.
+    bool TakeReport(ProfileReport& report) {
+        const uint32_t state = request_.load(std::memory_order_acquire);
+        if(state == REPORT_IDLE) {
+            request_.store(REPORT_REQUESTED, std::memory_order_release);
+            return false;
+        }
+        if(state != REPORT_READY) {
+            return false;
+        }
+        Bank& bank = banks_[1 - active_.load(std::memory_order_relaxed)];
+        Summarize(bank, report);
+        ClearBank(bank);
+        request_.store(REPORT_IDLE, std::memory_order_release);
+        return true;
+    }
+
+    // Everything recorded in the active bank. Only while Process is not running
+    // (host tools, after rendering).
+    void Snapshot(ProfileReport& report) const { Summarize(banks_[active_.load(std::memory_order_relaxed)], report); }
+
+    static const char* StageName(int stage) {
+        static const char* const kNames[PROFILE_STAGE_COUNT] = {
+            "cycle tick", "triggers", "drones", "sparkles", "pad",
+            "sampler",    "delay",    "reverb", "meters",   "callback",
+        };
+        return kNames[stage];
+    }
+
+    // One table row per stage. Integer-only so it also works with the Seed's
+    // printf (newlib-nano has no float formatting by default).
+    static void FormatLine(const ProfileReport& report, int stage, char* buf, size_t size) {
+        const ProfileStats& s = report.stages[stage];
+        snprintf(buf, size, "%-10s n=%-7lu min=%-7lu mean=%-7lu p99=%-7lu max=%lu ns", StageName(stage),
+                 static_cast<unsigned long>(s.count), static_cast<unsigned long>(s.min_ns),
+                 static_cast<unsigned long>(s.mean_ns), static_cast<unsigned long>(s.p99_ns),
+                 static_cast<unsigned long>(s.max_ns));
+    }
+
+  private:
+    // Log2 buckets with 8 linear steps per octave: values below 8 map to themselves.
+    static const int kSubBits = 3;
+    static const int kBuckets = (32 - kSubBits + 1) << kSubBits;
+
+    struct Histogram {
+        uint32_t count;
+        uint32_t min;
+        uint32_t max;
+        uint64_t sum;
+        uint32_t buckets[kBuckets];
+    };
+
+    struct Bank {
+        Histogram stages[PROFILE_STAGE_COUNT];
+    };
+
+    enum : uint32_t {
+        REPORT_IDLE,      // main loop has not asked yet
+        REPORT_REQUESTED, // audio thread swaps banks at the end of the next callback
+        REPORT_READY,     // inactive bank holds a finished window
+    };
+
+    static int Bucket(uint32_t v) {
+        if(v < (1u << kSubBits)) {
+            return static_cast<int>(v);
+        }
+        const int e = 31 - __builtin_clz(v);
+        return ((e - kSubBits + 1) << kSubBits) + static_cast<int>((v >> (e - kSubBits)) & ((1u << kSubBits) - 1u));
+    }
+
+    // Largest value that falls into bucket b.
+    static uint64_t BucketTop(int b) {
+        if(b < (1 << kSubBits)) {
+            return static_cast<uint64_t>(b);
+        }
+        const int      e    = (b >> kSubBits) + kSubBits - 1;
+        const uint64_t step = 1ull << (e - kSubBits);
+        const uint64_t base = (1ull << e) + static_cast<uint64_t>(b & ((1 << kSubBits) - 1)) * step;
+        return base + step - 1u;
+    }
+
+    static void ClearBank(Bank& bank) {
+        memset(&bank, 0, sizeof(bank));
+        for(int s = 0; s < PROFILE_STAGE_COUNT; s++) {
+            bank.stages[s].min = UINT32_MAX;
+        }
+    }
+
+    static void Record(Histogram& h, uint32_t ticks) {
+        h.count++;
+        h.sum += ticks;
+        h.min = ticks < h.min ? ticks : h.min;
+        h.max = ticks > h.max ? ticks : h.max;
+        h.buckets[Bucket(ticks)]++;
+    }
+
+    static uint32_t ToNs(uint64_t ticks) {
+#if defined(__arm__)
+        return static_cast<uint32_t>(ticks * 1000u / (SystemCoreClock / 1000000u));
+#else
+        return static_cast<uint32_t>(ticks);
+#endif
+    }
+
+    static void Summarize(const Bank& bank, ProfileReport& report) {
+        for(int s = 0; s < PROFILE_STAGE_COUNT; s++) {
+            const Histogram& h   = bank.stages[s];
+            ProfileStats&    out = report.stages[s];
+            out.count            = h.count;
+            if(h.count == 0) {
+                out.min_ns = out.mean_ns = out.max_ns = out.p99_ns = 0;
+                continue;
+            }
+            out.min_ns  = ToNs(h.min);
+            out.max_ns  = ToNs(h.max);
+            out.mean_ns = ToNs(h.sum / h.count);
+
+            // Smallest bucket with at least 99% of the samples at or below it.
+            const uint64_t target = (static_cast<uint64_t>(h.count) * 99u + 99u) / 100u;
+            uint64_t       seen   = 0;
+            int            b      = 0;
+            for(; b < kBuckets - 1; b++) {
+                seen += h.buckets[b];
+                if(seen >= target) {
+                    break;
+                }
+            }
+            const uint64_t top = BucketTop(b);
+            out.p99_ns         = ToNs(top < h.max ? top : h.max);
+        }
+    }
+
+    Bank     banks_[2];
+    uint32_t pending_[PROFILE_STAGE_COUNT]; // this callback's sum per stage
+    uint32_t ran_;                          // stages that ran in this callback
+    uint32_t callback_start_;
+
+    std::atomic<int>      active_; // bank the audio thread writes
+    std::atomic<uint32_t> request_;
+};
+
+// Times the enclosing scope into `stage`.
+class ProfileScope {
+  public:
+    ProfileScope(StageProfiler& profiler, ProfileStage stage)
+    : profiler_(profiler), stage_(stage), start_(StageProfiler::Now()) {}
+    ~ProfileScope() { profiler_.Add(stage_, start_); }
+
+  private:
+    StageProfiler& profiler_;
+    ProfileStage   stage_;
+    uint32_t       start_;
+};
+
+} // namespace ambient
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(profiler, stage) \
+    ::ambient::ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)((profiler), (stage))
+#define PROFILE_BEGIN_CALLBACK(profiler) (profiler).BeginCallback()
+#define PROFILE_END_CALLBACK(profiler) (profiler).EndCallback()
+
+#else
+
+#define PROFILE_SCOPE(profiler, stage)
+#define PROFILE_BEGIN_CALLBACK(profiler)
+#define PROFILE_END_CALLBACK(profiler)
+
+#endif // AMBIENT_PROFILE
+
+#endif // STAGE_PROFILER_H
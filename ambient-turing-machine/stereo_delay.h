@@ -0,0 +1,172 @@
+// stereo_delay.h
+// Stereo Delay — Interleaved, Reduced-Precision Delay Memory Read and Written per Block
+// Replaces a pair of daisysp::DelayLine<float, N>. Frames are stored as L/R pairs,
+// as float, int16 or bf16 (half the memory). The right channel's extra delay is
+// applied when it is written, so both channels of a frame are read from the same
+// place: one contiguous read stream and one write stream per block instead of
+// four scattered ones. The delay time glides towards its target at a bounded slew,
+// read with linear interpolation, so it can change live without zipper noise.
+// With DelayFloat32 and a steady delay the output matches the DelayLine pair bit
+// for bit. Header-only, no DaisySP dependency.
+
+#ifndef STEREO_DELAY_H
+#define STEREO_DELAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ambient {
+
+// =============================================
+// SAMPLE FORMATS
+// =============================================
+
+struct DelayFloat32 {
+    typedef float Stored;
+    static Stored Encode(float x) { return x; }
+    static float  Decode(Stored s) { return s; }
+};
+
+// Fixed point with 6 dB of headroom (full scale +-2.0); noise floor about -84 dBFS.
+struct DelayInt16 {
+    typedef int16_t Stored;
+    static Stored Encode(float x) {
+        float s = x * 16384.0f;
+        s       = s > 32767.0f ? 32767.0f : (s < -32768.0f ? -32768.0f : s);
+        return static_cast<int16_t>(s < 0.0f ? s - 0.5f : s + 0.5f);
+    }
+    static float Decode(Stored s) { return static_cast<float>(s) * (1.0f / 16384.0f); }
+};
+
+// Top half of a float, rounded to nearest even: 8-bit mantissa, float's range.
+// Error is relative (about -54 dB of the signal), so quiet tails keep their detail.
+struct DelayBf16 {
+    typedef uint16_t Stored;
+    static Stored Encode(float x) {
+        uint32_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        bits += 0x7FFFu + ((bits >> 16) & 1u);
+        return static_cast<uint16_t>(bits >> 16);
+    }
+    static float Decode(Stored s) {
+        const uint32_t bits = static_cast<uint32_t>(s) << 16;
+        float          x;
+        memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+};
+
+// =============================================
+// STEREO DELAY
+// =============================================
+
+template <typename Format, uint32_t MaxFrames>
+class StereoDelay {
+  public:
+    typedef typename Format::Stored Stored;
+
+    void Init() {
+        memset(line_, 0, sizeof(line_));
+        write_pos_ = 0;
+        r_offset_  = 0;
+        delay_     = 1.0f;
+        target_    = 1.0f;
+        slew_      = 0.25f;
+        started_   = false;
+    }
+
+    // Delay of the left channel in frames (fractional, up to MaxDelay()). The first
+    // call after Init jumps; later calls glide there at the slew rate.
+    void SetDelay(float frames) {
+        const float max_d = MaxDelay();
+        target_           = frames < 1.0f ? 1.0f : (frames > max_d ? max_d : frames);
+        if(!started_) {
+            delay_   = target_;
+            started_ = true;
+        }
+    }
+
+    // Extra delay of the right channel in whole frames. Set it before any audio is
+    // written; changing it later mixes old and new timing for one pass.
+    void SetRightOffset(uint32_t frames) { r_offset_ = frames; }
+
+    // Largest change of the delay per frame while gliding; the default 0.25 bends
+    // the repeats by at most 25% in pitch, like a tape delay catching up.
+    void SetSlew(float frames_per_frame) { slew_ = frames_per_frame; }
+
+    float Delay() const { return delay_; }
+
+    // Longest usable left delay: the right channel's write-ahead shares the memory.
+    float MaxDelay() const { return static_cast<float>(MaxFrames - 2u - r_offset_); }
+
+    // Reads the next `size` frames of delayed signal. Call once per block before
+    // Write; the delay must stay above `size` frames so the block's reads never see
+    // its own writes.
+    void Read(float* out_l, float* out_r, size_t size) {
+        const float delay = delay_;
+        const float min_d = static_cast<float>(size) + 1.0f;
+        const float goal  = target_ > min_d ? target_ : min_d;
+        const float total = static_cast<float>(size) * slew_;
+        float       move  = goal - delay;
+        move              = move > total ? total : (move < -total ? -total : move);
+        const float step  = move / static_cast<float>(size);
+
+        for(size_t i = 0; i < size; i++) {
+            // Same taps and blend as DelayLine::Read: the frame `d` writes ago and the one before it.
+            const float   d     = delay + step * static_cast<float>(i);
+            const int32_t d_int = static_cast<int32_t>(d);
+            const float   frac  = d - static_cast<float>(d_int);
+
+            int32_t a = static_cast<int32_t>(write_pos_ + static_cast<uint32_t>(i)) - d_int;
+            a         = a < 0 ? a + static_cast<int32_t>(MaxFrames) : a;
+            int32_t b = a - 1;
+            b         = b < 0 ? b + static_cast<int32_t>(MaxFrames) : b;
+
+            const float al = Format::Decode(line_[a * 2]);
+            const float ar = Format::Decode(line_[a * 2 + 1]);
+            const float bl = Format::Decode(line_[b * 2]);
+            const float br = Format::Decode(line_[b * 2 + 1]);
+            out_l[i]       = al + (bl - al) * frac;
+            out_r[i]       = ar + (br - ar) * frac;
+        }
+        delay_ = delay + move;
+    }
+
+    // Writes `size` frames and advances time by them.
+    void Write(const float* in_l, const float* in_r, size_t size) {
+        WriteChannel(0, write_pos_, in_l, size);
+        const uint32_t r_pos = write_pos_ + r_offset_;
+        WriteChannel(1, r_pos >= MaxFrames ? r_pos - MaxFrames : r_pos, in_r, size);
+
+        const uint32_t next = write_pos_ + static_cast<uint32_t>(size);
+        write_pos_          = next >= MaxFrames ? next - MaxFrames : next;
+    }
+
+  private:
+    void WriteChannel(int channel, uint32_t pos, const float* in, size_t size) {
+        const uint32_t left  = MaxFrames - pos;
+        const size_t   first = left < size ? left : size;
+        Stored* const  dst   = line_ + channel;
+        for(size_t i = 0; i < first; i++) {
+            dst[(pos + i) * 2] = Format::Encode(in[i]);
+        }
+        for(size_t i = first; i < size; i++) {
+            dst[(i - first) * 2] = Format::Encode(in[i]);
+        }
+    }
+
+    // The frame written at time t goes to slot t mod MaxFrames (left) and
+    // (t + r_offset_) mod MaxFrames (right); reads take slot write_pos_ + i - delay.
+    uint32_t write_pos_;
+    uint32_t r_offset_;
+    float    delay_;  // current left delay in frames
+    float    target_; // SetDelay value, reached at slew_ frames per frame
+    float    slew_;
+    bool     started_; // false until the first SetDelay after Init
+    Stored   line_[MaxFrames * 2];
+};
+
+} // namespace ambient
+
+#endif // STEREO_DELAY_H
@@ -0,0 +1,276 @@
+"""Converts a WAV into the sample blob the engine plays (see sample_asset.h):
+mono, DC removed, resampled, loop seam crossfaded and normalized to int16, then
+stored as IMA-ADPCM or raw PCM16 blocks behind a 32-byte header."""
+
+import argparse
+import math
+import pathlib
+import struct
+import wave
+
+
+def read_wav_to_mono_float(path: pathlib.Path):
+    with wave.open(str(path), "rb") as w:
+        channels = w.getnchannels()
+        sample_width = w.getsampwidth()
+        sample_rate = w.getframerate()
+        frame_count = w.getnframes()
+        raw = w.readframes(frame_count)
+
+    if sample_width not in (1, 2):
+        raise ValueError(f"Unsupported sample width: {sample_width} bytes")
+
+    samples_per_frame = channels
+    total_samples = frame_count * samples_per_frame
+
+    mono = [0.0] * frame_count
+
+    if sample_width == 1:
+        # 8-bit PCM is unsigned
+        for i in range(frame_count):
+            acc = 0.0
+            base = i * samples_per_frame
+            for ch in range(channels):
+                u = raw[base + ch]
+                acc += (u - 128.0) / 128.0
+            mono[i] = acc / channels
+    else:
+        # 16-bit PCM is signed little endian
+        for i in range(frame_count):
+            acc = 0.0
+            base = i * samples_per_frame * 2
+            for ch in range(channels):
+                lo = raw[base + ch * 2]
+                hi = raw[base + ch * 2 + 1]
+                v = int.from_bytes(bytes((lo, hi)), byteorder="little", signed=True)
+                acc += v / 32768.0
+            mono[i] = acc / channels
+
+    # Remove DC offset
+    mean = sum(mono) / len(mono)
+    mono = [x - mean for x in mono]
+
+    return mono, sample_rate, channels, sample_width
+
+
+def linear_resample(data, src_rate, dst_rate):
+    if src_rate == dst_rate:
+        return data
+
+    dst_len = int(round(len(data) * dst_rate / src_rate))
+    out = [0.0] * dst_len
+    ratio = src_rate / dst_rate
+
+    for i in range(dst_len):
+        src_pos = i * ratio
+        i0 = int(src_pos)
+        i1 = min(i0 + 1, len(data) - 1)
+        frac = src_pos - i0
+        out[i] = data[i0] + frac * (data[i1] - data[i0])
+
+    return out
+
+
+def bake_loop(data, loop_start, loop_end, fade):
+    """Crossfades the loop seam into the data so the player can jump from loop_end
+    to the returned loop start without a click or any gain math.
+
+    The last `fade` samples of the loop are blended (equal power) into the audio
+    that leads up to the loop start, so sample loop_end - 1 flows into the loop
+    start. Without that much audio before loop_start, the loop start moves
+    forward by `fade` and the skipped samples serve as the lead-in. The intro
+    (before the loop start) also fades in from silence, since playback starts
+    at sample 0."""
+    fade = min(fade, (loop_end - loop_start) // 2)
+    if fade <= 0:
+        return list(data), loop_start, 0
+
+    if loop_start >= fade:
+        lead_in = loop_start - fade
+        new_start = loop_start
+    else:
+        lead_in = loop_start
+        new_start = loop_start + fade
+
+    out = list(data)
+    tail = loop_end - fade
+    for k in range(fade):
+        t = (k + 0.5) / fade
+        out[tail + k] = data[tail + k] * math.cos(0.5 * math.pi * t) + data[lead_in + k] * math.sin(0.5 * math.pi * t)
+
+    intro = min(fade, new_start)
+    for k in range(intro):
+        out[k] *= k / intro
+
+    return out, new_start, fade
+
+
+def float_to_int16(data):
+    out = []
+    peak = max(abs(x) for x in data) if data else 1.0
+    norm = 1.0 / peak if peak > 1.0 else 1.0
+
+    for x in data:
+        v = max(-1.0, min(1.0, x * norm))
+        out.append(int(round(v * 32767.0)))
+    return out
+
+
+# Block layout shared with sample_stream.h (SampleCodec, kSampleBlockSamples).
+CODEC_PCM16 = 0
+CODEC_IMA_ADPCM = 1
+BLOCK_SAMPLES = 256
+
+IMA_STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767,
+]
+IMA_INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def encode_pcm16(samples):
+    out = bytearray()
+    for s in samples:
+        out += int(s).to_bytes(2, byteorder="little", signed=True)
+    return bytes(out), list(samples)
+
+
+def encode_ima_adpcm(samples):
+    """Blocks of BLOCK_SAMPLES: int16 first sample, uint8 step index, uint8 0,
+    then one 4-bit code per remaining sample (low nibble first). Returns the
+    encoded bytes and the decoder's exact output for the error report."""
+    out = bytearray()
+    decoded = []
+    index = 0
+    for start in range(0, len(samples), BLOCK_SAMPLES):
+        block = samples[start:start + BLOCK_SAMPLES]
+        pred = block[0]
+        out += int(pred).to_bytes(2, byteorder="little", signed=True)
+        out += bytes((index, 0))
+        decoded.append(pred)
+
+        codes = []
+        for s in block[1:]:
+            step = IMA_STEP_TABLE[index]
+            diff = s - pred
+            code = 0
+            if diff < 0:
+                code = 8
+                diff = -diff
+            if diff >= step:
+                code |= 4
+                diff -= step
+            if diff >= step >> 1:
+                code |= 2
+                diff -= step >> 1
+            if diff >= step >> 2:
+                code |= 1
+
+            # Reconstruct exactly as AdpcmDecodeBlock does.
+            delta = step >> 3
+            if code & 4:
+                delta += step
+            if code & 2:
+                delta += step >> 1
+            if code & 1:
+                delta += step >> 2
+            pred = pred - delta if code & 8 else pred + delta
+            pred = max(-32768, min(32767, pred))
+            index = max(0, min(88, index + IMA_INDEX_TABLE[code]))
+
+            codes.append(code)
+            decoded.append(pred)
+
+        codes += [0] * (BLOCK_SAMPLES - len(codes))
+        for k in range(0, BLOCK_SAMPLES // 2):
+            out.append(codes[2 * k] | (codes[2 * k + 1] << 4))
+
+    return bytes(out), decoded
+
+
+# Header layout shared with sample_asset.h (SampleBlobHeader, 32 bytes, little endian).
+BLOB_MAGIC = 0x42535441  # "ATSB"
+BLOB_VERSION = 1
+
+
+def write_blob(out_path: pathlib.Path, rate, length, loop_start, loop_end, codec, data):
+    header = struct.pack(
+        "<IHBBIIIIII",
+        BLOB_MAGIC,
+        BLOB_VERSION,
+        codec,
+        0,
+        rate,
+        length,
+        loop_start,
+        loop_end,
+        BLOCK_SAMPLES,
+        len(data),
+    )
+    assert len(header) == 32
+    out_path.write_bytes(header + data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert WAV to a mono 48k sample bed blob")
+    parser.add_argument("--input", required=True)
+    parser.add_argument("--out", default="sample.bin")
+    parser.add_argument("--rate", type=int, default=48000)
+    parser.add_argument("--loop-start", type=int, default=0, help="first looped sample")
+    parser.add_argument("--loop-end", type=int, default=0, help="end of the loop (0 = whole sample)")
+    parser.add_argument("--crossfade", type=int, default=-1,
+                        help="loop seam crossfade in samples (default 50 ms, 0 = none)")
+    parser.add_argument("--format", choices=("adpcm", "pcm16"), default="adpcm",
+                        help="IMA-ADPCM blocks (~3.9x smaller) or raw int16")
+    args = parser.parse_args()
+
+    input_path = pathlib.Path(args.input)
+    out_path = pathlib.Path(args.out)
+
+    mono, src_rate, channels, sample_width = read_wav_to_mono_float(input_path)
+    resampled = linear_resample(mono, src_rate, args.rate)
+
+    loop_end = args.loop_end if args.loop_end > 0 else len(resampled)
+    if not 0 <= args.loop_start < loop_end <= len(resampled):
+        parser.error(f"loop must satisfy 0 <= start < end <= {len(resampled)}")
+    crossfade = args.crossfade if args.crossfade >= 0 else args.rate // 20
+    looped, loop_start, crossfade = bake_loop(resampled, args.loop_start, loop_end, crossfade)
+
+    int16 = float_to_int16(looped)
+
+    if args.format == "adpcm":
+        codec = CODEC_IMA_ADPCM
+        data, decoded = encode_ima_adpcm(int16)
+    else:
+        codec = CODEC_PCM16
+        data, decoded = encode_pcm16(int16)
+
+    signal = sum(float(s) * s for s in int16)
+    noise = sum(float(a - b) * (a - b) for a, b in zip(int16, decoded))
+    snr_db = 10.0 * math.log10(signal / noise) if noise > 0.0 else float("inf")
+
+    write_blob(out_path, args.rate, len(int16), loop_start, loop_end, codec, data)
+
+    print(f"input={input_path}")
+    print(f"source_channels={channels}")
+    print(f"source_width_bytes={sample_width}")
+    print(f"source_rate={src_rate}")
+    print(f"target_rate={args.rate}")
+    print(f"output_samples={len(int16)}")
+    print(f"duration_sec={len(int16) / args.rate:.3f}")
+    print(f"format={args.format}")
+    print(f"encoded_bytes={len(data)}")
+    print(f"compression={len(int16) * 2 / len(data):.2f}x")
+    print(f"snr_db={snr_db:.1f}")
+    print(f"loop={loop_start}..{loop_end}")
+    print(f"crossfade={crossfade}")
+    print(f"out={out_path}")
+
+
+if __name__ == "__main__":
+    main()
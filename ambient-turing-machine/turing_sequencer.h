@@ -7,9 +7,10 @@
 #ifndef TURING_SEQUENCER_H
 #define TURING_SEQUENCER_H
 
-#include <cmath>
 #include <cstdint>
 
+#include "fast_math.h"
+
 namespace turing {
 
 // =============================================
@@ -17,15 +18,15 @@ namespace turing {
 // =============================================
 
 // Chromatic note names (for display/debug only)
-static const char* NOTE_NAMES[] = {
+static const char* const NOTE_NAMES[] = {
     "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
 };
 
 // Major scale intervals in semitones from root
-static const int MAJOR_SCALE[] = {0, 2, 4, 5, 7, 9, 11};
+static constexpr int MAJOR_SCALE[] = {0, 2, 4, 5, 7, 9, 11};
 
 // Circle of fifths as chromatic indices (C=0, G=7, D=2, A=9, ...)
-static const int CIRCLE_OF_FIFTHS[] = {0, 7, 2, 9, 4, 11, 6, 1, 8, 3, 10, 5};
+static constexpr int CIRCLE_OF_FIFTHS[] = {0, 7, 2, 9, 4, 11, 6, 1, 8, 3, 10, 5};
 
 // =============================================
 // VOICE STRUCTURE
@@ -74,10 +75,10 @@ struct SequencerState {
 // HELPER: Degree + Root + Octave → MIDI note
 // =============================================
 
-inline int degree_to_midi(int root_chromatic, int degree, int base_octave, int min_octave = -1) {
+constexpr int degree_to_midi(int root_chromatic, int degree, int base_octave, int min_octave = -1) {
     // Normalize degree with octave overflow
     int oct_offset = 0;
-    int norm_degree;
+    int norm_degree = 0;
 
     if (degree >= 0) {
         oct_offset = degree / 7;
@@ -91,20 +92,21 @@ inline int degree_to_midi(int root_chromatic, int degree, int base_octave, int m
     int semitone_offset = MAJOR_SCALE[norm_degree];
     int midi = (base_octave + oct_offset) * 12 + root_chromatic + semitone_offset;
 
-    // Clamp to min octave if specified
+    // Clamp to min octave if specified: raise by whole octaves. One step, since
+    // the Mirror's degree drifts down without bound over a long run.
     if (min_octave >= 0) {
         int min_midi = min_octave * 12;
-        while (midi < min_midi) {
-            midi += 12;
+        if (midi < min_midi) {
+            midi += (min_midi - midi + 11) / 12 * 12;
         }
     }
 
     return midi;
 }
 
-// MIDI note to frequency
+// MIDI note to frequency (12-TET table, no powf; see fast_math.h)
 inline float midi_to_freq(int midi_note) {
-    return 440.0f * powf(2.0f, (midi_note - 69) / 12.0f);
+    return fastmath::midi_to_freq(midi_note);
 }
 
 // Extract chromatic index and octave from MIDI note
@@ -307,6 +309,79 @@ inline void sequencer_nudge_root(SequencerState& s) {
     s.cycle = next;
 }
 
+// =============================================
+// SEQUENCER SEEK — Jump to any cycle
+// Every gate pattern (12/7/5/3/4) and the V5 walk (21) repeat every
+// SEQUENCER_PERIOD cycles, and so does every follower rule: once the
+// history fields have been filled from real ticks, each period moves the
+// frozen degrees by the same amount. A seek ticks for real until it is a
+// whole number of periods before the target, ticks one period to measure
+// that drift, adds it for the periods in between, and ticks the last
+// cycle for real so every note is recomputed from the shifted state.
+// The result equals ticking all the way (host/build/sequencer_seek_check),
+// in at most about 2 * SEQUENCER_PERIOD + SEQUENCER_SEEK_WARMUP ticks.
+// =============================================
+
+static const uint32_t SEQUENCER_PERIOD = 420; // lcm(12, 7, 5, 3, 4, 21)
+
+// Real ticks before the drift is measured: enough for prev_gate, the V5
+// history and a fresh V2 trigger (V2 fires at least every 15 cycles).
+static const uint32_t SEQUENCER_SEEK_WARMUP = 32;
+
+// Advances `s` until s.cycle == target, exactly as repeated sequencer_tick
+// calls would. A target at or behind s.cycle leaves `s` unchanged.
+// Returns the number of real ticks it ran.
+inline uint32_t sequencer_seek(SequencerState& s, uint32_t target) {
+    if (target <= s.cycle) {
+        return 0;
+    }
+    uint32_t ticks = 0;
+    if (target - s.cycle <= 2 * SEQUENCER_PERIOD + SEQUENCER_SEEK_WARMUP + 1) {
+        while (s.cycle != target) {
+            sequencer_tick(s);
+            ticks++;
+        }
+        return ticks;
+    }
+
+    // Warm up, then line up so whole periods remain before the last cycle.
+    const uint32_t last = target - 1;
+    for (uint32_t i = 0; i < SEQUENCER_SEEK_WARMUP; i++) {
+        sequencer_tick(s);
+        ticks++;
+    }
+    while ((last - s.cycle) % SEQUENCER_PERIOD != 0) {
+        sequencer_tick(s);
+        ticks++;
+    }
+
+    // One real period gives the per-period drift of every history field.
+    const int v2_before   = s.frozen_v2_degree;
+    const int v4_before   = s.frozen_v4_degree;
+    const int v6_before   = s.frozen_v6_degree;
+    const int echo_before = s.prev_v4_degree_for_echo;
+    for (uint32_t i = 0; i < SEQUENCER_PERIOD; i++) {
+        sequencer_tick(s);
+        ticks++;
+    }
+
+    // The fields below only ever change by whole periods' worth; the rest of
+    // the state is the same at s.cycle and at `last`. Unsigned arithmetic
+    // keeps the wrap of last_v2_trigger_cycle identical to the ticked path.
+    const uint32_t periods = (last - s.cycle) / SEQUENCER_PERIOD;
+    const int      n       = static_cast<int>(periods);
+    s.frozen_v2_degree += n * (s.frozen_v2_degree - v2_before);
+    s.frozen_v4_degree += n * (s.frozen_v4_degree - v4_before);
+    s.frozen_v6_degree += n * (s.frozen_v6_degree - v6_before);
+    s.prev_v4_degree_for_echo += n * (s.prev_v4_degree_for_echo - echo_before);
+    s.last_v2_trigger_cycle = static_cast<int>(static_cast<uint32_t>(s.last_v2_trigger_cycle) + periods * SEQUENCER_PERIOD);
+    s.cycle = last;
+
+    // Recomputes every voice's note, octave and gate from the shifted state.
+    sequencer_tick(s);
+    return ticks + 1;
+}
+
 } // namespace turing
 
 #endif // TURING_SEQUENCER_H
@@ -0,0 +1,189 @@
+// voice_pool.h
+// Voice Pool — Allocation, Stealing and a CPU Budget for Triggered Voices
+// A VoicePool keeps the bookkeeping for N interchangeable voices: who started each
+// one (follower and trigger group), when, how loud its last run was and the gain it
+// plays at. The engine owns the voices themselves and renders only active slots.
+// Allocation takes a free slot; when none is free, or the CPU budget's voice count
+// is already playing, it steals the quietest voice, preferring released ones.
+// CpuBudget turns the measured callback load into that voice count, with
+// hysteresis so it sheds early and grows back slowly.
+// Header-only, no DaisySP dependency.
+
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ambient {
+
+// =============================================
+// VOICE POOL
+// =============================================
+
+template <int N>
+class VoicePool {
+  public:
+    static const int kSize = N;
+
+    struct Slot {
+        uint64_t start;       // sample time of the trigger
+        float    level;       // peak follower of the voice at unity gain, kept by the engine
+        float    gain;        // gain the voice is mixed at
+        float    gain_step;   // per-sample change while ramp_left > 0
+        uint32_t ramp_left;   // samples left in the current gain ramp
+        uint8_t  group;       // trigger that started it; layers of one trigger share it
+        int8_t   owner;       // follower index, or -1 when free
+        bool     released;
+        bool     shedding; // fading out; freed when the ramp reaches 0
+    };
+
+    void Init() {
+        for(int i = 0; i < N; i++) {
+            Free(i);
+        }
+    }
+
+    bool        Active(int i) const { return slots_[i].owner >= 0; }
+    Slot&       operator[](int i) { return slots_[i]; }
+    const Slot& operator[](int i) const { return slots_[i]; }
+
+    // Slots playing (shedding ones included: they still cost a render).
+    int Count() const {
+        int n = 0;
+        for(int i = 0; i < N; i++) {
+            n += Active(i) ? 1 : 0;
+        }
+        return n;
+    }
+
+    // Slot for a new voice. A free one while fewer than `limit` play; otherwise
+    // the voice to steal, which the caller restarts from scratch. Voices of
+    // `group` (the trigger being started) are never stolen, so one layer cannot
+    // take another's slot. -1 when nothing can be stolen: the caller drops the voice.
+    int Allocate(int limit, int group) {
+        if(Count() < limit) {
+            for(int i = 0; i < N; i++) {
+                if(!Active(i)) {
+                    return i;
+                }
+            }
+        }
+        return Quietest(true, group);
+    }
+
+    void Start(int i, int owner, uint8_t group, uint64_t now, float gain) {
+        Slot& s     = slots_[i];
+        s.start     = now;
+        s.level     = 0.0f;
+        s.gain      = gain;
+        s.gain_step = 0.0f;
+        s.ramp_left = 0;
+        s.group     = group;
+        s.owner     = static_cast<int8_t>(owner);
+        s.released  = false;
+        s.shedding  = false;
+    }
+
+    // Glides slot i's gain to `gain` over `samples` (>= 1).
+    void RampGain(int i, float gain, uint32_t samples) {
+        slots_[i].gain_step = (gain - slots_[i].gain) / static_cast<float>(samples);
+        slots_[i].ramp_left = samples;
+    }
+
+    void Free(int i) {
+        slots_[i].owner     = -1;
+        slots_[i].released  = false;
+        slots_[i].shedding  = false;
+        slots_[i].level     = 0.0f;
+        slots_[i].ramp_left = 0;
+    }
+
+    // Quietest active voice that is not already fading out, by level * gain, or -1.
+    // With prefer_released, released voices win over held ones; ties go to the oldest.
+    // Voices of skip_group (0..255) are passed over; -1 skips none.
+    int Quietest(bool prefer_released, int skip_group = -1) const {
+        int best = -1;
+        for(int i = 0; i < N; i++) {
+            const Slot& s = slots_[i];
+            if(!Active(i) || s.shedding || s.group == skip_group) {
+                continue;
+            }
+            if(best < 0) {
+                best = i;
+                continue;
+            }
+            const Slot& b = slots_[best];
+            if(prefer_released && s.released != b.released) {
+                best = s.released ? i : best;
+                continue;
+            }
+            const float ls = s.level * s.gain;
+            const float lb = b.level * b.gain;
+            if(ls < lb || (ls == lb && s.start < b.start)) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+  private:
+    Slot slots_[N];
+};
+
+// =============================================
+// CPU BUDGET
+// =============================================
+
+// Voice count for the measured callback load (render time / callback period).
+// The load is followed with instant attack and slow release, so one slow callback
+// counts for a while. Above kHighLoad one voice is shed per kShedHold callbacks;
+// below kLowLoad one comes back per kGrowHold callbacks.
+class CpuBudget {
+  public:
+    static constexpr float kHighLoad = 0.80f;
+    static constexpr float kLowLoad  = 0.60f;
+    static constexpr float kRelease  = 0.02f; // per callback
+    static const uint32_t  kShedHold = 4;
+    static const uint32_t  kGrowHold = 200;
+
+    void Init(int min_voices, int max_voices) {
+        min_voices_ = min_voices;
+        max_voices_ = max_voices;
+        voices_     = max_voices;
+        load_       = 0.0f;
+        hold_       = 0;
+        shed_total_ = 0;
+    }
+
+    void Report(float load) {
+        load_ = load > load_ ? load : load_ + (load - load_) * kRelease;
+        if(hold_ > 0) {
+            hold_--;
+        }
+        if(load_ > kHighLoad && voices_ > min_voices_ && hold_ == 0) {
+            voices_--;
+            shed_total_++;
+            hold_ = kShedHold;
+        } else if(load_ < kLowLoad && voices_ < max_voices_ && hold_ == 0) {
+            voices_++;
+            hold_ = kGrowHold;
+        }
+    }
+
+    int      Voices() const { return voices_; }
+    float    Load() const { return load_; }
+    uint32_t ShedTotal() const { return shed_total_; } // times the count was lowered
+
+  private:
+    int      min_voices_;
+    int      max_voices_;
+    int      voices_;
+    float    load_;
+    uint32_t hold_;
+    uint32_t shed_total_;
+};
+
+} // namespace ambient
+
+#endif // VOICE_POOL_H
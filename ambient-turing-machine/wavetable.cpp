@@ -0,0 +1,66 @@
+#include "wavetable.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace ambient {
+
+static constexpr uint32_t LevelFloats(int level) {
+    return level == Wavetables::kLevels ? 0 : Wavetables::Length(level) + 2 + LevelFloats(level + 1);
+}
+static_assert(LevelFloats(0) == Wavetables::kShapeFloats, "kShapeFloats must cover every level");
+
+static Wavetables shared_wavetables;
+
+Wavetables& SharedWavetables() {
+    return shared_wavetables;
+}
+
+void Wavetables::Init() {
+    if(ready_) {
+        return;
+    }
+
+    uint32_t offset = 0;
+    for(int level = 0; level < kLevels; level++) {
+        offset_[level] = offset;
+        offset += Length(level) + 2;
+    }
+    memset(data_, 0, sizeof(data_));
+
+    // Saw: (2/pi) sum sin(2 pi h p) / h. Triangle: (8/pi^2) sum over odd h of
+    // cos(2 pi h p) / h^2. Each harmonic's sine and cosine come from one rotating
+    // phasor (in double), so a level costs two trig calls per harmonic.
+    for(int level = 0; level < kLevels; level++) {
+        const uint32_t length    = Length(level);
+        const uint32_t harmonics = kTopHarmonics >> level;
+        float* const   saw       = data_[SHAPE_SAW] + offset_[level];
+        float* const   tri       = data_[SHAPE_TRI] + offset_[level];
+
+        for(uint32_t h = 1; h <= harmonics; h++) {
+            const double w       = 2.0 * M_PI * static_cast<double>(h) / static_cast<double>(length);
+            const double rot_c   = cos(w);
+            const double rot_s   = sin(w);
+            const double saw_amp = 2.0 / (M_PI * static_cast<double>(h));
+            const double tri_amp = (h & 1u) ? 8.0 / (M_PI * M_PI * static_cast<double>(h * h)) : 0.0;
+            double       c       = 1.0;
+            double       s       = 0.0;
+            for(uint32_t n = 0; n < length; n++) {
+                saw[n] += static_cast<float>(s * saw_amp);
+                tri[n] += static_cast<float>(c * tri_amp);
+                const double next_c = c * rot_c - s * rot_s;
+                s                   = s * rot_c + c * rot_s;
+                c                   = next_c;
+            }
+        }
+
+        // Guard samples: a read at phase 1.0 interpolates towards the start.
+        saw[length]     = saw[0];
+        saw[length + 1] = saw[1];
+        tri[length]     = tri[0];
+        tri[length + 1] = tri[1];
+    }
+    ready_ = true;
+}
+
+} // namespace ambient
@@ -0,0 +1,165 @@
+// wavetable.h
+// Wavetables — Shared Mipmapped Band-Limited Saw and Triangle Tables
+// One table set per waveform, generated once at startup by summing harmonics, and
+// read by any number of oscillators. Level k holds the first 512 >> k harmonics,
+// so an oscillator picks the level whose top harmonic stays below Nyquist for its
+// pitch and needs no aliasing correction while it plays. Tables shrink with their
+// harmonic count (4 samples per harmonic, at least 64), so both shapes together
+// take 34 KB; reads are one linear interpolation between neighbouring samples.
+// Phase conventions match daisysp::Oscillator: the saw falls from +1 (WAVE_SAW,
+// WAVE_POLYBLEP_SAW) and the triangle starts at +1 (WAVE_TRI).
+// No DaisySP dependency. Used with `make OSC=wavetable` (AMBIENT_OSC_WAVETABLE).
+
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ambient {
+
+class Wavetables {
+  public:
+    enum Shape : uint8_t {
+        SHAPE_SAW, // all harmonics, 1/n
+        SHAPE_TRI, // odd harmonics, 1/n^2
+        SHAPE_COUNT,
+    };
+
+    static const int      kLevels       = 10;
+    static const uint32_t kTopHarmonics = 512; // in level 0
+    static const uint32_t kMinLength    = 64;
+
+    // Samples in a level's table (excluding the two guard samples that repeat its
+    // start, so a read at phase 1.0 needs no wrap).
+    static constexpr uint32_t Length(int level) {
+        return 4u * (kTopHarmonics >> level) > kMinLength ? 4u * (kTopHarmonics >> level) : kMinLength;
+    }
+
+    // Memory of one shape across all levels, guard samples included.
+    static const uint32_t kShapeFloats = 4308; // checked in wavetable.cpp
+
+    // Level for a phase increment (cycles per sample): the lowest level whose
+    // harmonics all stay at or below Nyquist, i.e. (512 >> level) * inc <= 0.5.
+    static int LevelFor(float inc) {
+        const float x = inc * static_cast<float>(2u * kTopHarmonics);
+        if(!(x > 1.0f)) {
+            return 0;
+        }
+        // ceil(log2(x)) from the float's exponent and mantissa.
+        uint32_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        int level = static_cast<int>((bits >> 23) & 0xFFu) - 127 + ((bits & 0x7FFFFFu) != 0 ? 1 : 0);
+        return level < kLevels ? level : kLevels - 1;
+    }
+
+    // Highest increment `level` plays without aliasing; the top level takes all above.
+    static float MaxInc(int level) {
+        return level < kLevels - 1 ? static_cast<float>(1u << level) / static_cast<float>(2u * kTopHarmonics) : 1.0e30f;
+    }
+
+    // Fills every table. Allocation-free and idempotent; call before audio starts.
+    void Init();
+    bool Ready() const { return ready_; }
+
+    const float* Table(Shape shape, int level) const { return data_[shape] + offset_[level]; }
+
+    // Linear interpolation at `phase` in [0, 1].
+    static float Read(const float* table, uint32_t length, float phase) {
+        const float    x    = phase * static_cast<float>(length);
+        const uint32_t i    = static_cast<uint32_t>(x);
+        const float    frac = x - static_cast<float>(i);
+        return table[i] + (table[i + 1] - table[i]) * frac;
+    }
+
+  private:
+    bool     ready_;
+    uint32_t offset_[kLevels];
+    float    data_[SHAPE_COUNT][kShapeFloats];
+};
+
+// The one table set every oscillator reads.
+Wavetables& SharedWavetables();
+
+// =============================================
+// OSCILLATOR
+// =============================================
+// The subset of daisysp::Oscillator the voices use, over the shared tables, so it
+// can stand in for one. The first Init fills the shared tables, so oscillators are
+// initialised at startup, never from the audio callback.
+
+class WavetableOscillator {
+  public:
+    // daisysp::Oscillator waveform numbers: the triangles play SHAPE_TRI, every
+    // other waveform SHAPE_SAW.
+    static const uint8_t kDaisyWaveTri         = 1;
+    static const uint8_t kDaisyWavePolyblepTri = 5;
+
+    void Init(float sample_rate) {
+        SharedWavetables().Init();
+        tables_   = &SharedWavetables();
+        sr_recip_ = 1.0f / sample_rate;
+        shape_    = Wavetables::SHAPE_SAW;
+        amp_      = 0.5f;
+        phase_    = 0.0f;
+        SetFreq(100.0f);
+    }
+
+    void SetWaveform(uint8_t waveform) {
+        shape_ = (waveform == kDaisyWaveTri || waveform == kDaisyWavePolyblepTri) ? Wavetables::SHAPE_TRI
+                                                                                   : Wavetables::SHAPE_SAW;
+        SelectLevel();
+    }
+
+    void SetAmp(float amp) { amp_ = amp; }
+
+    // Cheap to call per sample: the level is only looked up again when the
+    // increment leaves the range the current one covers.
+    void SetFreq(float freq) {
+        inc_ = freq * sr_recip_;
+        // At or above the sample rate Process's single wrap cannot keep the phase
+        // in the table; the alias below the sample rate gives the same samples.
+        if(inc_ >= 1.0f) {
+            inc_ = inc_ < 16777216.0f ? inc_ - static_cast<float>(static_cast<uint32_t>(inc_)) : 0.0f;
+        }
+        if(inc_ > level_max_ || inc_ <= level_min_) {
+            SelectLevel();
+        }
+    }
+
+    void Reset(float phase = 0.0f) { phase_ = phase; }
+
+    float Process() {
+        const float out = Wavetables::Read(table_, length_, phase_) * amp_;
+        phase_ += inc_;
+        if(phase_ > 1.0f) {
+            phase_ -= 1.0f;
+        }
+        return out;
+    }
+
+  private:
+    void SelectLevel() {
+        const int level = Wavetables::LevelFor(inc_);
+        table_          = tables_->Table(shape_, level);
+        length_         = Wavetables::Length(level);
+        level_max_      = Wavetables::MaxInc(level);
+        level_min_      = level > 0 ? Wavetables::MaxInc(level - 1) : -1.0f;
+    }
+
+    const Wavetables* tables_;
+    const float*      table_;
+    uint32_t          length_;
+    Wavetables::Shape shape_;
+    float             sr_recip_;
+    float             amp_;
+    float             phase_;
+    float             inc_;
+    float             level_min_; // LevelFor(inc_) stays put for level_min_ < inc_ <= level_max_
+    float             level_max_;
+};
+
+} // namespace ambient
+
+#endif // WAVETABLE_H
@@ -0,0 +1,74 @@
+// AudioWorklet processor that runs the firmware engine (web/wasm, built to
+// build/atm.wasm) on the audio rendering thread. It only moves data: controls
+// from the shared ring into atm_control(), 128 rendered frames per quantum out
+// to the node's output, and the engine's meter block back to the page.
+//
+// processorOptions: { wasm: ArrayBuffer, sample: ArrayBuffer | null, bpm: number,
+//                     shared: SharedArrayBuffer | null }
+// Without `shared` (page not cross-origin isolated) controls arrive as port
+// messages and meters go back as port messages about 20 times a second.
+
+import { ControlRing, MeterBlock, METER_WORDS } from "./atm-ring.js";
+
+// Quanta between meter messages on the port fallback.
+const METER_MESSAGE_QUANTA = 16;
+
+class AtmProcessor extends AudioWorkletProcessor {
+  constructor(options) {
+    super();
+    const { wasm, sample, bpm, shared } = options.processorOptions;
+
+    // Compiled here rather than on the page, so nothing but bytes crosses over.
+    this.engine = new WebAssembly.Instance(new WebAssembly.Module(wasm), {}).exports;
+
+    let sampleBytes = 0;
+    if (sample) {
+      const dst = this.engine.atm_sample_buffer(sample.byteLength);
+      if (dst) {
+        new Uint8Array(this.engine.memory.buffer, dst, sample.byteLength).set(new Uint8Array(sample));
+        sampleBytes = sample.byteLength;
+      }
+    }
+    const sampleOk = this.engine.atm_init(sampleRate, bpm, sampleBytes) === 1;
+
+    // The module's memory never grows (web/wasm/Makefile), so these views stay valid.
+    this.heap = new Float32Array(this.engine.memory.buffer);
+    this.meters = new Int32Array(this.engine.memory.buffer, this.engine.atm_meters(), METER_WORDS);
+
+    if (shared) {
+      this.controls = new ControlRing(shared);
+      this.meterBlock = new MeterBlock(shared);
+    } else {
+      this.controls = null;
+      this.meterBlock = null;
+      this.quanta = 0;
+      this.port.onmessage = (event) => this.engine.atm_control(event.data.type, event.data.value);
+    }
+
+    this.port.postMessage({ type: "ready", sampleOk });
+  }
+
+  process(inputs, outputs) {
+    const engine = this.engine;
+    if (this.controls) {
+      this.controls.drain((type, value) => engine.atm_control(type, value));
+    }
+
+    const out = outputs[0];
+    const frames = Math.min(out[0].length, 128);
+    const base = engine.atm_render(frames) >> 2;
+    out[0].set(this.heap.subarray(base, base + frames));
+    if (out.length > 1) {
+      out[1].set(this.heap.subarray(base + frames, base + 2 * frames));
+    }
+
+    if (this.meterBlock) {
+      this.meterBlock.publish(this.meters);
+    } else if (++this.quanta % METER_MESSAGE_QUANTA === 0) {
+      this.port.postMessage({ type: "meters", words: this.meters.slice() });
+    }
+    return true;
+  }
+}
+
+registerProcessor("atm-processor", AtmProcessor);
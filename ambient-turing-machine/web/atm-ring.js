@@ -0,0 +1,108 @@
+// Shared-memory link between the page and the engine worklet (atm-processor.js).
+//
+// One SharedArrayBuffer, viewed as 32-bit words:
+//   0                    control head (advanced by the page)
+//   1                    control tail (advanced by the worklet)
+//   2 ..                 CONTROL_CAPACITY slots of [type, value as float bits]
+//   METER_SEQ            meter sequence: odd while the worklet is writing
+//   METER_BASE ..        WebMeters from web/wasm/atm_web.cpp, METER_WORDS words
+//
+// The page is the only control producer and the worklet the only consumer, so the
+// ring needs no locks; the meter block is a seqlock the page retries on a torn read.
+
+export const CONTROL = Object.freeze({
+  BPM_POT: 0,    // value: pot position 0..1
+  NUDGE: 1,      // root-advance button press
+  DELAY_TIME: 2, // value: seconds
+});
+
+export const METER_WORDS = 32;
+
+const CONTROL_CAPACITY = 64; // power of two
+const HEAD = 0;
+const TAIL = 1;
+const SLOTS = 2;
+const METER_SEQ = SLOTS + 2 * CONTROL_CAPACITY;
+const METER_BASE = METER_SEQ + 1;
+
+export const SHARED_BYTES = (METER_BASE + METER_WORDS) * 4;
+
+export class ControlRing {
+  constructor(shared) {
+    this.words = new Int32Array(shared);
+    this.floats = new Float32Array(shared);
+  }
+
+  // Page side. Returns false when the ring is full; the control is dropped, as a
+  // full engine control queue drops it on the Seed.
+  push(type, value = 0) {
+    const head = Atomics.load(this.words, HEAD);
+    const tail = Atomics.load(this.words, TAIL);
+    if (((head - tail) >>> 0) >= CONTROL_CAPACITY) return false;
+    const slot = SLOTS + 2 * (head & (CONTROL_CAPACITY - 1));
+    this.words[slot] = type;
+    this.floats[slot + 1] = value;
+    Atomics.store(this.words, HEAD, (head + 1) | 0);
+    return true;
+  }
+
+  // Worklet side: hands every pending control to apply(type, value), in order.
+  drain(apply) {
+    const head = Atomics.load(this.words, HEAD);
+    let tail = Atomics.load(this.words, TAIL);
+    while (tail !== head) {
+      const slot = SLOTS + 2 * (tail & (CONTROL_CAPACITY - 1));
+      apply(this.words[slot], this.floats[slot + 1]);
+      tail = (tail + 1) | 0;
+    }
+    Atomics.store(this.words, TAIL, tail);
+  }
+}
+
+export class MeterBlock {
+  constructor(shared) {
+    this.words = new Int32Array(shared);
+  }
+
+  // Worklet side: copies the engine's meter words in.
+  publish(source) {
+    const seq = (this.words[METER_SEQ] + 1) | 0;
+    Atomics.store(this.words, METER_SEQ, seq);
+    this.words.set(source, METER_BASE);
+    Atomics.store(this.words, METER_SEQ, (seq + 1) | 0);
+  }
+
+  // Page side: copies a consistent snapshot into `out` (METER_WORDS long).
+  // Returns false if every attempt overlapped a write; `out` is then unchanged.
+  read(out) {
+    for (let attempt = 0; attempt < 4; attempt++) {
+      const before = Atomics.load(this.words, METER_SEQ);
+      if (before & 1) continue;
+      const snapshot = this.words.slice(METER_BASE, METER_BASE + METER_WORDS);
+      if (Atomics.load(this.words, METER_SEQ) === before) {
+        out.set(snapshot);
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+// Field view of a meter snapshot (layout: struct WebMeters in web/wasm/atm_web.cpp).
+export function decodeMeters(words) {
+  const floats = new Float32Array(words.buffer, words.byteOffset, METER_WORDS);
+  return {
+    leds: floats.subarray(0, 6),
+    busRms: floats.subarray(6, 12),
+    busPeak: floats.subarray(12, 18),
+    cycle: words[18] >>> 0,
+    root: words[19],
+    notes: words.subarray(20, 26),
+    gates: words[26],
+    bpm: floats[27],
+    voicesActive: words[28],
+    voiceBudget: words[29],
+    underruns: words[30] >>> 0,
+    elapsedMs: words[31] >>> 0,
+  };
+}
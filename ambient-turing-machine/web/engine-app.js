@@ -0,0 +1,188 @@
+// Page side of the firmware engine preview (engine.html). All DSP runs in
+// atm-processor.js on the audio thread; this file loads the module, forwards the
+// controls and draws the meters the worklet publishes.
+
+import { CONTROL, ControlRing, MeterBlock, METER_WORDS, SHARED_BYTES, decodeMeters } from "./atm-ring.js";
+
+const NOTE_NAMES = ["C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"];
+const MIN_BPM = 30; // ambient::Machine::kMinBpm
+const MAX_BPM = 120; // ambient::Machine::kMaxBpm
+
+const VOICE_META = [
+  { id: "V1", role: "Root drone", rgb: "193, 82, 66" },
+  { id: "V2", role: "Mirror sparkle", rgb: "72, 136, 120" },
+  { id: "V3", role: "Third drone", rgb: "86, 106, 154" },
+  { id: "V4", role: "Wanderer sparkle", rgb: "159, 114, 57" },
+  { id: "V5", role: "Scale walker drone", rgb: "117, 90, 150" },
+  { id: "V6", role: "String pad", rgb: "69, 124, 159" },
+];
+
+const ui = {
+  start: document.getElementById("start"),
+  stop: document.getElementById("stop"),
+  nudge: document.getElementById("nudge"),
+  status: document.getElementById("status"),
+  readout: document.getElementById("readout"),
+  grid: document.getElementById("voice-grid"),
+  bpm: document.getElementById("bpm"),
+  bpmValue: document.getElementById("bpm-value"),
+  delayTime: document.getElementById("delay-time"),
+  delayTimeValue: document.getElementById("delay-time-value"),
+};
+
+const voices = VOICE_META.map((meta) => {
+  const card = document.createElement("article");
+  card.className = "voice-card";
+  card.style.setProperty("--voice-outline", `rgba(${meta.rgb}, 0.46)`);
+  card.style.setProperty("--voice-core", `rgba(${meta.rgb}, 0.42)`);
+  card.style.setProperty("--voice-glow", `rgba(${meta.rgb}, 0.34)`);
+
+  const top = document.createElement("div");
+  top.className = "voice-top";
+  const id = document.createElement("strong");
+  id.className = "voice-id";
+  id.textContent = meta.id;
+  const role = document.createElement("span");
+  role.className = "voice-role";
+  role.textContent = meta.role;
+  top.append(id, role);
+
+  const circle = document.createElement("div");
+  circle.className = "voice-circle";
+  const note = document.createElement("span");
+  note.className = "voice-note";
+  note.textContent = "--";
+  circle.append(note);
+
+  const level = document.createElement("p");
+  level.className = "voice-role mono";
+
+  card.append(top, circle, level);
+  ui.grid.append(card);
+  return { circle, note, level };
+});
+
+let context = null;
+let node = null;
+let sendControl = null;
+let meterBlock = null;
+let frameRequest = 0;
+const meterWords = new Int32Array(METER_WORDS);
+
+function noteName(midi) {
+  return `${NOTE_NAMES[((midi % 12) + 12) % 12]}${Math.floor(midi / 12) - 1}`;
+}
+
+function setStatus(text) {
+  ui.status.textContent = text;
+}
+
+function drawMeters() {
+  if (meterBlock) meterBlock.read(meterWords);
+  const m = decodeMeters(meterWords);
+  voices.forEach((voice, v) => {
+    const gated = (m.gates >> v) & 1;
+    voice.circle.classList.toggle("active", m.leds[v] > 0.5);
+    voice.circle.style.opacity = (0.55 + 0.45 * m.leds[v]).toFixed(3);
+    voice.note.textContent = gated ? noteName(m.notes[v]) : "--";
+    voice.level.textContent = `rms ${m.busRms[v].toFixed(3)}  peak ${m.busPeak[v].toFixed(3)}`;
+  });
+  const seconds = Math.floor(m.elapsedMs / 1000);
+  ui.readout.textContent =
+    `cycle ${m.cycle}  root ${NOTE_NAMES[m.root] ?? "-"}  ${m.bpm.toFixed(1)} bpm  ` +
+    `voices ${m.voicesActive}/${m.voiceBudget}  underruns ${m.underruns}  ` +
+    `${Math.floor(seconds / 60)}:${String(seconds % 60).padStart(2, "0")}`;
+  frameRequest = requestAnimationFrame(drawMeters);
+}
+
+async function fetchBuffer(url, required) {
+  const response = await fetch(url);
+  if (!response.ok) {
+    if (required) throw new Error(`${url} not found (run make in web/wasm)`);
+    return null;
+  }
+  return response.arrayBuffer();
+}
+
+async function start() {
+  ui.start.disabled = true;
+  setStatus("Loading engine...");
+  try {
+    const [wasm, sample] = await Promise.all([
+      fetchBuffer("./build/atm.wasm", true),
+      fetchBuffer("./build/sample.bin", false).catch(() => null),
+    ]);
+
+    context = new AudioContext({ latencyHint: "playback" });
+    await context.audioWorklet.addModule("./atm-processor.js");
+
+    // The shared ring needs a cross-origin isolated page (serve.py sends the
+    // headers); otherwise controls and meters travel as port messages.
+    const shared = self.crossOriginIsolated ? new SharedArrayBuffer(SHARED_BYTES) : null;
+    node = new AudioWorkletNode(context, "atm-processor", {
+      numberOfInputs: 0,
+      numberOfOutputs: 1,
+      outputChannelCount: [2],
+      processorOptions: { wasm, sample, bpm: Number(ui.bpm.value), shared },
+    });
+
+    if (shared) {
+      const ring = new ControlRing(shared);
+      sendControl = (type, value) => ring.push(type, value);
+      meterBlock = new MeterBlock(shared);
+    } else {
+      sendControl = (type, value) => node.port.postMessage({ type, value });
+      meterBlock = null;
+    }
+
+    const ready = new Promise((resolve) => {
+      node.port.onmessage = (event) => {
+        if (event.data.type === "ready") resolve(event.data);
+        else if (event.data.type === "meters") meterWords.set(event.data.words);
+      };
+    });
+    node.connect(context.destination);
+    const { sampleOk } = await ready;
+
+    sendControl(CONTROL.DELAY_TIME, Number(ui.delayTime.value));
+    ui.stop.disabled = false;
+    ui.nudge.disabled = false;
+    setStatus(`Running at ${context.sampleRate} Hz${sampleOk ? "" : " (no sample bed)"}${shared ? "" : ", port fallback"}`);
+    frameRequest = requestAnimationFrame(drawMeters);
+  } catch (error) {
+    setStatus(`Error: ${error.message}`);
+    await stop();
+  }
+}
+
+// Hard stop, as in the tuning rig: closing the context drops every tail at once.
+async function stop() {
+  cancelAnimationFrame(frameRequest);
+  if (context) await context.close();
+  context = null;
+  node = null;
+  sendControl = null;
+  meterBlock = null;
+  ui.start.disabled = false;
+  ui.stop.disabled = true;
+  ui.nudge.disabled = true;
+  if (!ui.status.textContent.startsWith("Error")) setStatus("Stopped");
+}
+
+function updateLabels() {
+  ui.bpmValue.textContent = `${ui.bpm.value} bpm`;
+  ui.delayTimeValue.textContent = `${Number(ui.delayTime.value).toFixed(2)} s`;
+}
+
+ui.start.addEventListener("click", start);
+ui.stop.addEventListener("click", stop);
+ui.nudge.addEventListener("click", () => sendControl?.(CONTROL.NUDGE, 0));
+ui.bpm.addEventListener("input", () => {
+  updateLabels();
+  sendControl?.(CONTROL.BPM_POT, (Number(ui.bpm.value) - MIN_BPM) / (MAX_BPM - MIN_BPM));
+});
+ui.delayTime.addEventListener("input", () => {
+  updateLabels();
+  sendControl?.(CONTROL.DELAY_TIME, Number(ui.delayTime.value));
+});
+updateLabels();
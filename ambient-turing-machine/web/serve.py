@@ -0,0 +1,40 @@
+"""Serves web/ with the cross-origin isolation headers SharedArrayBuffer needs, so
+engine.html can use the shared control/meter ring instead of port messages.
+
+    python3 serve.py [--port 5500]
+"""
+
+import argparse
+import functools
+import http.server
+import pathlib
+
+
+class IsolatedHandler(http.server.SimpleHTTPRequestHandler):
+    extensions_map = {
+        **http.server.SimpleHTTPRequestHandler.extensions_map,
+        ".js": "text/javascript",
+        ".wasm": "application/wasm",
+    }
+
+    def end_headers(self):
+        self.send_header("Cross-Origin-Opener-Policy", "same-origin")
+        self.send_header("Cross-Origin-Embedder-Policy", "credentialless")
+        self.send_header("Cache-Control", "no-store")
+        super().end_headers()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--port", type=int, default=5500)
+    args = parser.parse_args()
+
+    root = pathlib.Path(__file__).resolve().parent
+    handler = functools.partial(IsolatedHandler, directory=str(root))
+    with http.server.ThreadingHTTPServer(("127.0.0.1", args.port), handler) as server:
+        print(f"http://127.0.0.1:{args.port}/engine.html")
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,169 @@
+// atm_web.cpp
+// Web Side of the Engine — One Machine Behind a C API for the AudioWorklet
+// The browser preview runs the same ambient::Machine the Seed runs, compiled to a
+// freestanding wasm32 module (see Makefile). web/atm-processor.js instantiates it
+// on the audio rendering thread and calls atm_render() once per 128-frame quantum;
+// everything else in the page only moves controls in and meters out.
+//
+// Call order: atm_sample_buffer() (copy the blob in), atm_init(), then
+// atm_control() / atm_render() / atm_meters() from the worklet thread alone.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "machine.h"
+#include "sample_data.h"
+
+// Largest sample bed accepted: the Seed's QSPI flash, which bounds the blob
+// there too.
+static const uint32_t kSampleBlobMax = 8u * 1024u * 1024u;
+
+// Frames per atm_render call; the Web Audio render quantum is 128.
+static const uint32_t kMaxFrames = 128;
+
+// =============================================
+// CONTROLS AND METERS
+// =============================================
+// The layout below is mirrored in web/atm-processor.js and web/engine-app.js.
+
+enum WebControl : uint32_t {
+    WEB_CONTROL_BPM_POT    = 0, // value: pot position 0..1, smoothed as on the Seed
+    WEB_CONTROL_NUDGE      = 1, // root-advance button press
+    WEB_CONTROL_DELAY_TIME = 2, // value: seconds
+};
+
+// Published at the end of every atm_render call. All fields are 32-bit, so the
+// worklet copies it word for word into the shared meter block.
+struct WebMeters {
+    float    led_levels[6]; // smoothed LED brightness 0..1 per sequencer voice
+    float    bus_rms[6];    // per-voice bus RMS, in LED order
+    float    bus_peak[6];   // per-voice bus |x| peak, in LED order
+    uint32_t cycle;         // sequencer cycle
+    int32_t  root;          // chromatic root 0-11
+    int32_t  notes[6];      // MIDI note per voice
+    uint32_t gates;         // bit i set while voice i is gated
+    float    bpm;           // tempo the engine runs at
+    uint32_t voices_active; // sparkle + pad voices playing
+    uint32_t voice_budget;  // voices the CPU budget allows
+    uint32_t underruns;     // sequencer cycles computed inline
+    uint32_t elapsed_ms;    // audio rendered since atm_init
+};
+static_assert(sizeof(WebMeters) == 128, "meter block layout is shared with the JS side");
+static_assert(offsetof(WebMeters, cycle) == 72 && offsetof(WebMeters, notes) == 80 && offsetof(WebMeters, bpm) == 108,
+              "meter block layout is shared with the JS side");
+
+// =============================================
+// STATE
+// =============================================
+
+static ambient::Machine     machine;
+static ambient::DelayBuffer delay;
+static float                bpm_pot;
+static uint32_t             poll_frames; // frames since the last Poll
+static uint32_t             poll_period; // frames per millisecond
+static WebMeters            meters;
+
+alignas(8) static uint8_t sample_blob[kSampleBlobMax];
+alignas(16) static float output[2 * kMaxFrames];        // interleaved, as the Seed's callback gets it
+alignas(16) static float output_planar[2 * kMaxFrames]; // left block, then right block
+
+// Web side of sample_data.h: the page fetches the blob and copies it into
+// sample_blob before atm_init parses it.
+ambient::SampleView sample_data;
+
+bool LoadLinkedSampleData() {
+    return false;
+}
+
+bool MapSampleData(const char*) {
+    return false;
+}
+
+extern "C" void __wasm_call_ctors(void);
+
+// =============================================
+// EXPORTS
+// =============================================
+// Listed in the Makefile's EXPORTS.
+
+// Where the caller copies the sample blob (up to `bytes` long); null if it is
+// larger than kSampleBlobMax.
+extern "C" uint8_t* atm_sample_buffer(uint32_t bytes) {
+    return bytes <= kSampleBlobMax ? sample_blob : nullptr;
+}
+
+// Starts the machine at `bpm` after `sample_bytes` of blob were copied into the
+// sample buffer (0 plays without the sample bed). Returns 1 if the blob parsed.
+extern "C" int atm_init(float sample_rate, float bpm, uint32_t sample_bytes) {
+    static bool constructed = false;
+    if(!constructed) {
+        __wasm_call_ctors();
+        constructed = true;
+    }
+
+    // A malformed blob leaves the sample layer silent; everything else still plays.
+    const bool sample_ok = sample_bytes > 0 && sample_bytes <= kSampleBlobMax
+                           && ambient::ParseSampleBlob(sample_blob, sample_bytes, sample_data);
+
+    machine.Init(sample_rate, &delay, bpm);
+    bpm_pot     = ambient::Machine::PotForBpm(bpm);
+    poll_frames = 0;
+    poll_period = static_cast<uint32_t>(sample_rate / 1000.0f + 0.5f);
+    return sample_ok ? 1 : 0;
+}
+
+// One control from the page, in the order it was sent.
+extern "C" void atm_control(uint32_t type, float value) {
+    switch(type) {
+        case WEB_CONTROL_BPM_POT: bpm_pot = fminf(fmaxf(value, 0.0f), 1.0f); break;
+        case WEB_CONTROL_NUDGE: machine.NudgeRoot(); break;
+        case WEB_CONTROL_DELAY_TIME: machine.GetEngine().SetDelayTime(value); break;
+        default: break;
+    }
+}
+
+// Renders `frames` (at most 128) and returns the output as two planar blocks of
+// `frames` floats, left then right, ready for the worklet's output channels.
+extern "C" float* atm_render(uint32_t frames) {
+    if(frames > kMaxFrames) {
+        frames = kMaxFrames;
+    }
+    machine.Process(output, frames * 2);
+    for(uint32_t i = 0; i < frames; i++) {
+        output_planar[i]          = output[2 * i];
+        output_planar[frames + i] = output[2 * i + 1];
+    }
+
+    // The Seed's main loop polls about once a millisecond; keep the same rate so
+    // the BPM pot smoothing behaves the same.
+    poll_frames += frames;
+    while(poll_frames >= poll_period) {
+        poll_frames -= poll_period;
+        machine.Poll(bpm_pot);
+    }
+
+    const ambient::Engine&        engine = machine.GetEngine();
+    const ambient::MeterSnapshot  m      = engine.Meters();
+    const turing::SequencerState& seq    = engine.Sequencer();
+    uint32_t                      gates  = 0;
+    for(int v = 0; v < 6; v++) {
+        meters.led_levels[v] = m.led_levels[v];
+        meters.bus_rms[v]    = m.bus_rms[v];
+        meters.bus_peak[v]   = m.bus_peak[v];
+        meters.notes[v]      = seq.voices[v].midi_note;
+        gates |= seq.voices[v].gate ? 1u << v : 0u;
+    }
+    meters.cycle         = seq.cycle;
+    meters.root          = seq.root_chromatic;
+    meters.gates         = gates;
+    meters.bpm           = engine.Bpm();
+    meters.voices_active = m.voices_active;
+    meters.voice_budget  = m.voice_budget;
+    meters.underruns     = m.sequencer_underruns;
+    meters.elapsed_ms    = static_cast<uint32_t>(m.sample_clock * 1000u / static_cast<uint64_t>(engine.SampleRate()));
+    return output_planar;
+}
+
+extern "C" const WebMeters* atm_meters() {
+    return &meters;
+}
@@ -0,0 +1,8 @@
+// Freestanding <assert.h> for the wasm32 build: a failed assertion traps, which
+// the AudioWorklet reports as a processor error.
+#undef assert
+#if defined(NDEBUG)
+#define assert(e) ((void)0)
+#else
+#define assert(e) ((e) ? (void)0 : __builtin_trap())
+#endif
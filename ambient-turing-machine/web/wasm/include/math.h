@@ -0,0 +1,81 @@
+// Freestanding <math.h> for the wasm32 build; the functions are in ../libc.cpp.
+// sqrt, fabs, floor, ceil, trunc, rint and copysign compile to single wasm
+// instructions; the rest are evaluated in double precision, so the float forms
+// come out correctly rounded in practically every case.
+#pragma once
+
+#define HUGE_VAL  __builtin_huge_val()
+#define HUGE_VALF __builtin_huge_valf()
+#define INFINITY  __builtin_inff()
+#define NAN       __builtin_nanf("")
+
+#define M_E       2.7182818284590452354
+#define M_LN2     0.69314718055994530942
+#define M_LN10    2.30258509299404568402
+#define M_PI      3.14159265358979323846
+#define M_PI_2    1.57079632679489661923
+#define M_PI_4    0.78539816339744830962
+#define M_SQRT2   1.41421356237309504880
+#define M_SQRT1_2 0.70710678118654752440
+
+#define ATM_MATH_FUNCTIONS(X)                                                                                         \
+    X(sin)                                                                                                            \
+    X(cos)                                                                                                            \
+    X(tan)                                                                                                            \
+    X(asin)                                                                                                           \
+    X(acos)                                                                                                           \
+    X(atan)                                                                                                           \
+    X(sinh)                                                                                                           \
+    X(cosh)                                                                                                           \
+    X(tanh)                                                                                                           \
+    X(exp)                                                                                                            \
+    X(exp2)                                                                                                           \
+    X(expm1)                                                                                                          \
+    X(log)                                                                                                            \
+    X(log2)                                                                                                           \
+    X(log10)                                                                                                          \
+    X(log1p)                                                                                                          \
+    X(sqrt)                                                                                                           \
+    X(cbrt)                                                                                                           \
+    X(fabs)                                                                                                           \
+    X(floor)                                                                                                          \
+    X(ceil)                                                                                                           \
+    X(trunc)                                                                                                          \
+    X(round)                                                                                                          \
+    X(rint)                                                                                                           \
+    X(nearbyint)
+
+#define ATM_MATH_FUNCTIONS2(X)                                                                                        \
+    X(atan2)                                                                                                          \
+    X(pow)                                                                                                            \
+    X(fmod)                                                                                                           \
+    X(fmin)                                                                                                           \
+    X(fmax)                                                                                                           \
+    X(hypot)                                                                                                          \
+    X(copysign)
+
+extern "C" {
+#define ATM_DECLARE(name)                                                                                             \
+    double name(double);                                                                                              \
+    float  name##f(float);
+#define ATM_DECLARE2(name)                                                                                            \
+    double name(double, double);                                                                                      \
+    float  name##f(float, float);
+ATM_MATH_FUNCTIONS(ATM_DECLARE)
+ATM_MATH_FUNCTIONS2(ATM_DECLARE2)
+#undef ATM_DECLARE
+#undef ATM_DECLARE2
+
+double frexp(double x, int* exp);
+float  frexpf(float x, int* exp);
+double ldexp(double x, int exp);
+float  ldexpf(float x, int exp);
+double scalbn(double x, int exp);
+float  scalbnf(float x, int exp);
+double modf(double x, double* integral);
+float  modff(float x, float* integral);
+long   lround(double x);
+long   lroundf(float x);
+long   lrint(double x);
+long   lrintf(float x);
+}
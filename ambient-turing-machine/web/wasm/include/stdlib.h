@@ -0,0 +1,15 @@
+// Freestanding <stdlib.h> for the wasm32 build; the functions are in ../libc.cpp.
+// There is no heap: the module's only dynamic memory is the sample bed buffer.
+#pragma once
+#include <stddef.h>
+
+// newlib's generator, so rand() sequences match the Seed's.
+#define RAND_MAX 0x7fffffff
+
+extern "C" {
+int  rand(void);
+void srand(unsigned seed);
+int  abs(int x);
+long labs(long x);
+[[noreturn]] void abort(void);
+}
@@ -0,0 +1,732 @@
+// libc.cpp
+// Freestanding C and C++ Runtime for the wasm32 Engine Build
+// The module links against nothing but this file: the memory functions, newlib's
+// rand(), the math the engine and DaisySP call, and the few C++ ABI hooks clang
+// emits. Transcendentals are computed in double precision (argument reduction
+// plus Taylor/atanh series carried past 1e-17), so the float forms the engine
+// uses come out correctly rounded in practically every case; glibc on the host
+// and newlib on the Seed are within an ulp or two of them.
+// Compiled with -fno-builtin so the loops below are not turned back into calls.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// =============================================
+// MEMORY
+// =============================================
+// With bulk memory these are single memory.copy / memory.fill instructions.
+
+extern "C" void* memcpy(void* dst, const void* src, size_t n) {
+#if defined(__wasm_bulk_memory__)
+    __builtin_memcpy(dst, src, n);
+#else
+    unsigned char*       d = static_cast<unsigned char*>(dst);
+    const unsigned char* s = static_cast<const unsigned char*>(src);
+    while(n--) {
+        *d++ = *s++;
+    }
+#endif
+    return dst;
+}
+
+extern "C" void* memmove(void* dst, const void* src, size_t n) {
+#if defined(__wasm_bulk_memory__)
+    __builtin_memmove(dst, src, n);
+#else
+    unsigned char*       d = static_cast<unsigned char*>(dst);
+    const unsigned char* s = static_cast<const unsigned char*>(src);
+    if(d < s) {
+        while(n--) {
+            *d++ = *s++;
+        }
+    } else {
+        while(n--) {
+            d[n] = s[n];
+        }
+    }
+#endif
+    return dst;
+}
+
+extern "C" void* memset(void* dst, int c, size_t n) {
+#if defined(__wasm_bulk_memory__)
+    __builtin_memset(dst, c, n);
+#else
+    unsigned char* d = static_cast<unsigned char*>(dst);
+    while(n--) {
+        *d++ = static_cast<unsigned char>(c);
+    }
+#endif
+    return dst;
+}
+
+extern "C" int memcmp(const void* a, const void* b, size_t n) {
+    const unsigned char* p = static_cast<const unsigned char*>(a);
+    const unsigned char* q = static_cast<const unsigned char*>(b);
+    for(size_t i = 0; i < n; i++) {
+        if(p[i] != q[i]) {
+            return p[i] < q[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+extern "C" size_t strlen(const char* s) {
+    size_t n = 0;
+    while(s[n]) {
+        n++;
+    }
+    return n;
+}
+
+// =============================================
+// STDLIB
+// =============================================
+
+// newlib's rand(): the same sequence DaisySP's noise sources draw on the Seed.
+static uint64_t rand_state = 1;
+
+extern "C" void srand(unsigned seed) {
+    rand_state = seed;
+}
+
+extern "C" int rand(void) {
+    rand_state = rand_state * 6364136223846793005ull + 1;
+    return static_cast<int>((rand_state >> 32) & RAND_MAX);
+}
+
+extern "C" int abs(int x) {
+    return x < 0 ? -x : x;
+}
+
+extern "C" long labs(long x) {
+    return x < 0 ? -x : x;
+}
+
+extern "C" void abort(void) {
+    __builtin_trap();
+}
+
+// =============================================
+// C++ RUNTIME
+// =============================================
+
+// Static objects live as long as the instance; their destructors never run.
+extern "C" int __cxa_atexit(void (*)(void*), void*, void*) {
+    return 0;
+}
+
+extern "C" void __cxa_pure_virtual() {
+    __builtin_trap();
+}
+
+// Nothing in the engine allocates; a stray new traps instead of corrupting memory.
+void* operator new(size_t) {
+    __builtin_trap();
+}
+void* operator new[](size_t) {
+    __builtin_trap();
+}
+void operator delete(void*) noexcept {}
+void operator delete[](void*) noexcept {}
+void operator delete(void*, size_t) noexcept {}
+void operator delete[](void*, size_t) noexcept {}
+
+// =============================================
+// MATH — BITS AND ROUNDING
+// =============================================
+
+static inline uint64_t Bits(double x) {
+    uint64_t u;
+    __builtin_memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+static inline double FromBits(uint64_t u) {
+    double x;
+    __builtin_memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+static const double kLn2Hi  = 6.93147180369123816490e-01; // ln 2, upper 32 bits
+static const double kLn2Lo  = 1.90821492927058770002e-10; // ln 2 - kLn2Hi
+static const double kInvLn2 = 1.44269504088896338700e+00;
+static const double kPi     = 3.14159265358979311600e+00;
+static const double kPi_2   = 1.57079632679489655800e+00;
+
+extern "C" double fabs(double x) { return __builtin_fabs(x); }
+extern "C" double sqrt(double x) { return __builtin_sqrt(x); }
+extern "C" double floor(double x) { return __builtin_floor(x); }
+extern "C" double ceil(double x) { return __builtin_ceil(x); }
+extern "C" double trunc(double x) { return __builtin_trunc(x); }
+extern "C" double rint(double x) { return __builtin_rint(x); }
+extern "C" double nearbyint(double x) { return __builtin_rint(x); }
+extern "C" double copysign(double x, double y) { return __builtin_copysign(x, y); }
+
+extern "C" double round(double x) {
+    double t = __builtin_trunc(x);
+    if(__builtin_fabs(x - t) >= 0.5) {
+        t += __builtin_copysign(1.0, x);
+    }
+    return t;
+}
+
+extern "C" long lround(double x) { return static_cast<long>(round(x)); }
+extern "C" long lrint(double x) { return static_cast<long>(__builtin_rint(x)); }
+
+// C semantics: a NaN argument loses to a number (the wasm min/max instructions
+// would propagate it).
+extern "C" double fmin(double x, double y) {
+    if(x != x) {
+        return y;
+    }
+    if(y != y) {
+        return x;
+    }
+    return y < x ? y : x;
+}
+
+extern "C" double fmax(double x, double y) {
+    if(x != x) {
+        return y;
+    }
+    if(y != y) {
+        return x;
+    }
+    return x < y ? y : x;
+}
+
+extern "C" double scalbn(double x, int n) {
+    if(n > 1023) {
+        x *= 0x1p1023;
+        n -= 1023;
+        if(n > 1023) {
+            x *= 0x1p1023;
+            n -= 1023;
+            if(n > 1023) {
+                n = 1023;
+            }
+        }
+    } else if(n < -1022) {
+        // Scale in steps that stay normal, so only the last one rounds.
+        x *= 0x1p-1022 * 0x1p53;
+        n += 1022 - 53;
+        if(n < -1022) {
+            x *= 0x1p-1022 * 0x1p53;
+            n += 1022 - 53;
+            if(n < -1022) {
+                n = -1022;
+            }
+        }
+    }
+    return x * FromBits(static_cast<uint64_t>(0x3ff + n) << 52);
+}
+
+extern "C" double ldexp(double x, int n) { return scalbn(x, n); }
+
+extern "C" double frexp(double x, int* exp) {
+    uint64_t  u = Bits(x);
+    const int e = static_cast<int>((u >> 52) & 0x7ff);
+    if(e == 0) {
+        if(x == 0.0) {
+            *exp = 0;
+            return x;
+        }
+        x = frexp(x * 0x1p64, exp);
+        *exp -= 64;
+        return x;
+    }
+    if(e == 0x7ff) {
+        *exp = 0;
+        return x;
+    }
+    *exp = e - 1022;
+    u    = (u & 0x800fffffffffffffull) | 0x3fe0000000000000ull;
+    return FromBits(u);
+}
+
+extern "C" double modf(double x, double* integral) {
+    const double t = __builtin_trunc(x);
+    *integral      = t;
+    return __builtin_isinf(x) ? __builtin_copysign(0.0, x) : x - t;
+}
+
+// Exact: each step subtracts y scaled by a power of two no larger than the
+// remainder, which Sterbenz's lemma keeps free of rounding.
+extern "C" double fmod(double x, double y) {
+    if(y == 0.0 || x != x || y != y || __builtin_isinf(x)) {
+        return __builtin_nan("");
+    }
+    double       r  = __builtin_fabs(x);
+    const double ay = __builtin_fabs(y);
+    while(r >= ay) {
+        int er, ey;
+        frexp(r, &er);
+        frexp(ay, &ey);
+        double t = scalbn(ay, er - ey);
+        if(t > r) {
+            t *= 0.5;
+        }
+        r -= t;
+    }
+    return __builtin_copysign(r, x);
+}
+
+// =============================================
+// MATH — EXPONENTIALS AND LOGARITHMS
+// =============================================
+
+// e^r for |r| <= ln(2)/2, Taylor series through r^13.
+static inline double ExpKernel(double r) {
+    double p = 1.0 / 6227020800.0;
+    p        = p * r + 1.0 / 479001600.0;
+    p        = p * r + 1.0 / 39916800.0;
+    p        = p * r + 1.0 / 3628800.0;
+    p        = p * r + 1.0 / 362880.0;
+    p        = p * r + 1.0 / 40320.0;
+    p        = p * r + 1.0 / 5040.0;
+    p        = p * r + 1.0 / 720.0;
+    p        = p * r + 1.0 / 120.0;
+    p        = p * r + 1.0 / 24.0;
+    p        = p * r + 1.0 / 6.0;
+    p        = p * r + 0.5;
+    p        = p * r + 1.0;
+    return p * r + 1.0;
+}
+
+extern "C" double exp(double x) {
+    if(x != x) {
+        return x;
+    }
+    if(x > 709.79) {
+        return __builtin_huge_val();
+    }
+    if(x < -745.2) {
+        return 0.0;
+    }
+    const double k = __builtin_rint(x * kInvLn2);
+    const double r = (x - k * kLn2Hi) - k * kLn2Lo;
+    return scalbn(ExpKernel(r), static_cast<int>(k));
+}
+
+extern "C" double exp2(double x) {
+    if(x != x) {
+        return x;
+    }
+    if(x > 1024.0) {
+        return __builtin_huge_val();
+    }
+    if(x < -1075.0) {
+        return 0.0;
+    }
+    // Integer powers come out exact.
+    const double k = __builtin_rint(x);
+    return scalbn(ExpKernel((x - k) * 0.693147180559945309417), static_cast<int>(k));
+}
+
+extern "C" double expm1(double x) {
+    if(__builtin_fabs(x) >= 0.5) {
+        return exp(x) - 1.0;
+    }
+    // Series without the leading 1, so small x keeps its precision (through x^17).
+    double p = 1.0 / 355687428096000.0;
+    p        = p * x + 1.0 / 20922789888000.0;
+    p        = p * x + 1.0 / 1307674368000.0;
+    p        = p * x + 1.0 / 87178291200.0;
+    p        = p * x + 1.0 / 6227020800.0;
+    p        = p * x + 1.0 / 479001600.0;
+    p        = p * x + 1.0 / 39916800.0;
+    p        = p * x + 1.0 / 3628800.0;
+    p        = p * x + 1.0 / 362880.0;
+    p        = p * x + 1.0 / 40320.0;
+    p        = p * x + 1.0 / 5040.0;
+    p        = p * x + 1.0 / 720.0;
+    p        = p * x + 1.0 / 120.0;
+    p        = p * x + 1.0 / 24.0;
+    p        = p * x + 1.0 / 6.0;
+    p        = p * x + 1.0 / 2.0;
+    return p * x * x + x;
+}
+
+// log(m) for m in [sqrt(1/2), sqrt(2)) as 2 atanh(s), s = (m - 1) / (m + 1),
+// |s| <= 0.1716; the series runs through s^21.
+static inline double LogKernel(double m) {
+    const double f  = m - 1.0;
+    const double s  = f / (2.0 + f);
+    const double s2 = s * s;
+    double       p  = 1.0 / 21.0;
+    p               = p * s2 + 1.0 / 19.0;
+    p               = p * s2 + 1.0 / 17.0;
+    p               = p * s2 + 1.0 / 15.0;
+    p               = p * s2 + 1.0 / 13.0;
+    p               = p * s2 + 1.0 / 11.0;
+    p               = p * s2 + 1.0 / 9.0;
+    p               = p * s2 + 1.0 / 7.0;
+    p               = p * s2 + 1.0 / 5.0;
+    p               = p * s2 + 1.0 / 3.0;
+    return 2.0 * s + 2.0 * s * s2 * p;
+}
+
+// Splits finite x > 0 into m * 2^e with m in [sqrt(1/2), sqrt(2)).
+static inline double SplitLog(double x, int& e) {
+    uint64_t u  = Bits(x);
+    int      be = static_cast<int>(u >> 52);
+    int      scale = 0;
+    if(be == 0) {
+        u     = Bits(x * 0x1p54);
+        be    = static_cast<int>(u >> 52);
+        scale = 54;
+    }
+    double m = FromBits((u & 0x000fffffffffffffull) | 0x3ff0000000000000ull);
+    e        = be - 1023 - scale;
+    if(m > 1.41421356237309504880) {
+        m *= 0.5;
+        e++;
+    }
+    return m;
+}
+
+// NaN for negative or NaN x, -inf for 0, inf for inf; 0 otherwise (go on).
+static inline bool LogSpecial(double x, double& result) {
+    if(x != x || x < 0.0) {
+        result = __builtin_nan("");
+        return true;
+    }
+    if(x == 0.0) {
+        result = -__builtin_huge_val();
+        return true;
+    }
+    if(__builtin_isinf(x)) {
+        result = x;
+        return true;
+    }
+    return false;
+}
+
+extern "C" double log(double x) {
+    double special;
+    if(LogSpecial(x, special)) {
+        return special;
+    }
+    int          e;
+    const double lm = LogKernel(SplitLog(x, e));
+    return e * kLn2Hi + (lm + e * kLn2Lo);
+}
+
+// Powers of two come out exact.
+extern "C" double log2(double x) {
+    double special;
+    if(LogSpecial(x, special)) {
+        return special;
+    }
+    int          e;
+    const double lm = LogKernel(SplitLog(x, e));
+    return e + lm * kInvLn2;
+}
+
+extern "C" double log10(double x) {
+    double special;
+    if(LogSpecial(x, special)) {
+        return special;
+    }
+    int          e;
+    const double lm = LogKernel(SplitLog(x, e));
+    return e * 3.01029995663981195214e-01 + lm * 4.34294481903251827651e-01;
+}
+
+extern "C" double log1p(double x) {
+    const double u = 1.0 + x;
+    if(u == 1.0) {
+        return x;
+    }
+    // Corrects for the rounding of 1 + x.
+    return log(u) * (x / (u - 1.0));
+}
+
+static inline bool IsOddInteger(double y) {
+    return __builtin_fabs(y) < 0x1p53 && __builtin_trunc(y) == y && __builtin_trunc(y * 0.5) != y * 0.5;
+}
+
+extern "C" double pow(double x, double y) {
+    if(y == 0.0 || x == 1.0) {
+        return 1.0;
+    }
+    if(x != x || y != y) {
+        return __builtin_nan("");
+    }
+    double sign = 1.0;
+    if(x < 0.0) {
+        if(__builtin_trunc(y) != y && !__builtin_isinf(y)) {
+            return __builtin_nan("");
+        }
+        if(IsOddInteger(y)) {
+            sign = -1.0;
+        }
+        x = -x;
+    }
+    if(x == 0.0) {
+        return y > 0.0 ? sign * 0.0 : sign * __builtin_huge_val();
+    }
+    return sign * exp(y * log(x));
+}
+
+extern "C" double cbrt(double x) {
+    if(x == 0.0 || x != x || __builtin_isinf(x)) {
+        return x;
+    }
+    const double ax = __builtin_fabs(x);
+    double       r  = exp(log(ax) * (1.0 / 3.0));
+    r -= (r - ax / (r * r)) * (1.0 / 3.0); // one Newton step
+    return __builtin_copysign(r, x);
+}
+
+extern "C" double sinh(double x) {
+    const double ax = __builtin_fabs(x);
+    if(ax < 0.5) {
+        const double t = expm1(ax);
+        return __builtin_copysign(0.5 * (t + t / (t + 1.0)), x);
+    }
+    const double e = exp(ax);
+    return __builtin_copysign(0.5 * (e - 1.0 / e), x);
+}
+
+extern "C" double cosh(double x) {
+    const double e = exp(__builtin_fabs(x));
+    return 0.5 * (e + 1.0 / e);
+}
+
+extern "C" double tanh(double x) {
+    const double ax = __builtin_fabs(x);
+    if(ax > 22.0) {
+        return __builtin_copysign(1.0, x);
+    }
+    const double t = expm1(2.0 * ax);
+    return __builtin_copysign(t / (t + 2.0), x);
+}
+
+extern "C" double hypot(double x, double y) {
+    x = __builtin_fabs(x);
+    y = __builtin_fabs(y);
+    if(__builtin_isinf(x) || __builtin_isinf(y)) {
+        return __builtin_huge_val();
+    }
+    const double big = x > y ? x : y;
+    if(big == 0.0 || big != big) {
+        return x + y;
+    }
+    const double a = x / big;
+    const double b = y / big;
+    return big * __builtin_sqrt(a * a + b * b);
+}
+
+// =============================================
+// MATH — TRIGONOMETRY
+// =============================================
+
+// sin and cos of |r| <= pi/4, Taylor series through r^19 / r^20.
+static inline double SinKernel(double r) {
+    const double r2 = r * r;
+    double       p  = -1.0 / 121645100408832000.0;
+    p               = p * r2 + 1.0 / 355687428096000.0;
+    p               = p * r2 - 1.0 / 1307674368000.0;
+    p               = p * r2 + 1.0 / 6227020800.0;
+    p               = p * r2 - 1.0 / 39916800.0;
+    p               = p * r2 + 1.0 / 362880.0;
+    p               = p * r2 - 1.0 / 5040.0;
+    p               = p * r2 + 1.0 / 120.0;
+    p               = p * r2 - 1.0 / 6.0;
+    return r + r * r2 * p;
+}
+
+static inline double CosKernel(double r) {
+    const double r2 = r * r;
+    double       p  = 1.0 / 2432902008176640000.0;
+    p               = p * r2 - 1.0 / 6402373705728000.0;
+    p               = p * r2 + 1.0 / 20922789888000.0;
+    p               = p * r2 - 1.0 / 87178291200.0;
+    p               = p * r2 + 1.0 / 479001600.0;
+    p               = p * r2 - 1.0 / 3628800.0;
+    p               = p * r2 + 1.0 / 40320.0;
+    p               = p * r2 - 1.0 / 720.0;
+    p               = p * r2 + 1.0 / 24.0;
+    p               = p * r2 - 0.5;
+    return 1.0 + r2 * p;
+}
+
+// Reduces x by multiples of pi/2 with a three-part Cody-Waite constant, exact
+// enough for |x| up to about 1e6 (the engine's phases stay within a few turns).
+// Returns the quadrant; `r` is in [-pi/4, pi/4].
+static inline int Reduce(double x, double& r) {
+    const double n = __builtin_rint(x * 6.36619772367581382433e-01);
+    r = ((x - n * 1.57079632673412561417e+00) - n * 6.07710050630396597660e-11) - n * 2.02226624871116645580e-21;
+    return static_cast<int>(static_cast<int64_t>(n) & 3);
+}
+
+extern "C" double sin(double x) {
+    if(__builtin_isinf(x) || x != x) {
+        return __builtin_nan("");
+    }
+    double r;
+    switch(Reduce(x, r)) {
+        case 0: return SinKernel(r);
+        case 1: return CosKernel(r);
+        case 2: return -SinKernel(r);
+        default: return -CosKernel(r);
+    }
+}
+
+extern "C" double cos(double x) {
+    if(__builtin_isinf(x) || x != x) {
+        return __builtin_nan("");
+    }
+    double r;
+    switch(Reduce(x, r)) {
+        case 0: return CosKernel(r);
+        case 1: return -SinKernel(r);
+        case 2: return -CosKernel(r);
+        default: return SinKernel(r);
+    }
+}
+
+extern "C" double tan(double x) {
+    if(__builtin_isinf(x) || x != x) {
+        return __builtin_nan("");
+    }
+    double    r;
+    const int q = Reduce(x, r);
+    const double s = SinKernel(r);
+    const double c = CosKernel(r);
+    return (q & 1) ? -c / s : s / c;
+}
+
+// atan of 0 <= t <= 2 - sqrt(3) (tan(pi/12)), odd series through t^29.
+static inline double AtanKernel(double t) {
+    const double t2 = t * t;
+    double       p  = 1.0 / 29.0;
+    for(int k = 27; k >= 3; k -= 2) {
+        p = p * t2 + ((k & 2) ? -1.0 : 1.0) / k; // t^k carries (-1)^((k - 1) / 2)
+    }
+    return t + t * t2 * p;
+}
+
+extern "C" double atan(double x) {
+    if(x != x) {
+        return x;
+    }
+    double t      = __builtin_fabs(x);
+    double offset = 0.0;
+    bool   invert = false;
+    if(t > 1.0) {
+        t      = 1.0 / t;
+        invert = true;
+    }
+    // atan(t) = pi/6 + atan((t sqrt(3) - 1) / (t + sqrt(3))).
+    if(t > 0.26794919243112270647) {
+        t      = (t * 1.73205080756887729353 - 1.0) / (t + 1.73205080756887729353);
+        offset = 5.23598775598298815658e-01;
+    }
+    double a = offset + AtanKernel(t);
+    if(invert) {
+        a = kPi_2 - a;
+    }
+    return __builtin_copysign(a, x);
+}
+
+extern "C" double atan2(double y, double x) {
+    if(x != x || y != y) {
+        return x + y;
+    }
+    if(y == 0.0) {
+        return __builtin_signbit(x) ? __builtin_copysign(kPi, y) : y;
+    }
+    if(x == 0.0) {
+        return __builtin_copysign(kPi_2, y);
+    }
+    if(__builtin_isinf(x)) {
+        if(__builtin_isinf(y)) {
+            return __builtin_copysign(x > 0.0 ? kPi_2 * 0.5 : kPi_2 * 1.5, y);
+        }
+        return x > 0.0 ? __builtin_copysign(0.0, y) : __builtin_copysign(kPi, y);
+    }
+    if(__builtin_isinf(y)) {
+        return __builtin_copysign(kPi_2, y);
+    }
+    const double a = atan(__builtin_fabs(y / x));
+    return __builtin_copysign(x > 0.0 ? a : kPi - a, y);
+}
+
+extern "C" double asin(double x) {
+    if(!(__builtin_fabs(x) <= 1.0)) {
+        return __builtin_nan("");
+    }
+    return atan2(x, __builtin_sqrt((1.0 - x) * (1.0 + x)));
+}
+
+extern "C" double acos(double x) {
+    if(!(__builtin_fabs(x) <= 1.0)) {
+        return __builtin_nan("");
+    }
+    return atan2(__builtin_sqrt((1.0 - x) * (1.0 + x)), x);
+}
+
+// =============================================
+// MATH — FLOAT FORMS
+// =============================================
+
+extern "C" float fabsf(float x) { return __builtin_fabsf(x); }
+extern "C" float sqrtf(float x) { return __builtin_sqrtf(x); }
+extern "C" float floorf(float x) { return __builtin_floorf(x); }
+extern "C" float ceilf(float x) { return __builtin_ceilf(x); }
+extern "C" float truncf(float x) { return __builtin_truncf(x); }
+extern "C" float rintf(float x) { return __builtin_rintf(x); }
+extern "C" float nearbyintf(float x) { return __builtin_rintf(x); }
+extern "C" float copysignf(float x, float y) { return __builtin_copysignf(x, y); }
+extern "C" long  lrintf(float x) { return static_cast<long>(__builtin_rintf(x)); }
+
+extern "C" float frexpf(float x, int* exp) { return static_cast<float>(frexp(x, exp)); }
+extern "C" float ldexpf(float x, int n) { return static_cast<float>(scalbn(x, n)); }
+extern "C" float scalbnf(float x, int n) { return static_cast<float>(scalbn(x, n)); }
+
+extern "C" float modff(float x, float* integral) {
+    double       i;
+    const double f = modf(x, &i);
+    *integral      = static_cast<float>(i);
+    return static_cast<float>(f);
+}
+
+#define ATM_FLOAT_FORM(name)                                                                                          \
+    extern "C" float name##f(float x) { return static_cast<float>(name(x)); }
+#define ATM_FLOAT_FORM2(name)                                                                                         \
+    extern "C" float name##f(float x, float y) { return static_cast<float>(name(x, y)); }
+
+ATM_FLOAT_FORM(sin)
+ATM_FLOAT_FORM(cos)
+ATM_FLOAT_FORM(tan)
+ATM_FLOAT_FORM(asin)
+ATM_FLOAT_FORM(acos)
+ATM_FLOAT_FORM(atan)
+ATM_FLOAT_FORM(sinh)
+ATM_FLOAT_FORM(cosh)
+ATM_FLOAT_FORM(tanh)
+ATM_FLOAT_FORM(exp)
+ATM_FLOAT_FORM(exp2)
+ATM_FLOAT_FORM(expm1)
+ATM_FLOAT_FORM(log)
+ATM_FLOAT_FORM(log2)
+ATM_FLOAT_FORM(log10)
+ATM_FLOAT_FORM(log1p)
+ATM_FLOAT_FORM(cbrt)
+ATM_FLOAT_FORM(round)
+ATM_FLOAT_FORM2(atan2)
+ATM_FLOAT_FORM2(pow)
+ATM_FLOAT_FORM2(fmod)
+ATM_FLOAT_FORM2(fmin)
+ATM_FLOAT_FORM2(fmax)
+ATM_FLOAT_FORM2(hypot)
+
+extern "C" long lroundf(float x) {
+    return lround(x);
+}
@@ -0,0 +1,64 @@
+// render_check.mjs
+// Renders the wasm module the way atm-processor.js drives it (128-frame quanta, no
+// control changes) and compares it with a host render of the same length:
+//
+//   ../../host/build/render --minutes 1 --block 128 --format float32 --bpm 50 --out host.wav
+//   node render_check.mjs ../build/atm.wasm ../build/sample.bin host.wav
+//
+// Prints how long the two stay bit-identical and the largest difference after
+// that (float libm rounding differs between the host's libc and libc.cpp).
+// Exits non-zero if any sample differs by more than 1e-6.
+
+import fs from "fs";
+
+const QUANTUM = 128;
+const TOLERANCE = 1e-6;
+
+const [wasmPath, samplePath, hostPath] = process.argv.slice(2);
+if (!hostPath) {
+  console.error("usage: node render_check.mjs ATM.wasm SAMPLE.bin HOST_FLOAT32.wav");
+  process.exit(2);
+}
+
+// Host render: 48 kHz stereo float32, the data chunk after the 44-byte header.
+const wav = fs.readFileSync(hostPath);
+if (wav.toString("latin1", 0, 4) !== "RIFF" || wav.readUInt16LE(20) !== 3 || wav.readUInt16LE(22) !== 2) {
+  console.error(`${hostPath}: not a stereo float32 WAV (render --format float32)`);
+  process.exit(2);
+}
+const sampleRate = wav.readUInt32LE(24);
+const dataBytes = wav.readUInt32LE(40);
+const host = new Float32Array(wav.buffer.slice(wav.byteOffset + 44, wav.byteOffset + 44 + dataBytes));
+const frames = host.length / 2;
+
+const engine = new WebAssembly.Instance(new WebAssembly.Module(fs.readFileSync(wasmPath)), {}).exports;
+const sample = fs.readFileSync(samplePath);
+const dst = engine.atm_sample_buffer(sample.length);
+new Uint8Array(engine.memory.buffer, dst, sample.length).set(sample);
+if (engine.atm_init(sampleRate, 50, sample.length) !== 1) {
+  console.error(`${samplePath}: the module rejected the sample blob`);
+  process.exit(2);
+}
+
+const heap = new Float32Array(engine.memory.buffer);
+let identical = frames;
+let worst = 0;
+const start = process.hrtime.bigint();
+for (let f = 0; f < frames; f += QUANTUM) {
+  const base = engine.atm_render(QUANTUM) >> 2;
+  const n = Math.min(QUANTUM, frames - f);
+  for (let i = 0; i < n; i++) {
+    const dl = Math.abs(heap[base + i] - host[2 * (f + i)]);
+    const dr = Math.abs(heap[base + QUANTUM + i] - host[2 * (f + i) + 1]);
+    if ((dl > 0 || dr > 0) && identical === frames) identical = f + i;
+    worst = Math.max(worst, dl, dr);
+  }
+}
+const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+
+console.log(`rendered ${(frames / sampleRate).toFixed(1)} s in ${seconds.toFixed(2)} s (${(frames / sampleRate / seconds).toFixed(1)}x realtime)`);
+console.log(`bit-identical for ${identical} frames (${(identical / sampleRate).toFixed(1)} s), max |diff| ${worst.toExponential(2)}`);
+if (worst > TOLERANCE) {
+  console.log(`FAIL: difference above ${TOLERANCE}`);
+  process.exit(1);
+}